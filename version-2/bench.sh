@@ -0,0 +1,26 @@
+#!/bin/sh
+# banc d'essai du solveur : faire chmod +x bench.sh puis executer depuis ce dossier.
+# sans base (ou avec --base), les mesures deviennent la base ; sinon elles sont
+# comparees a la base et le script echoue en cas de regression.
+
+
+EXEC="sokoban-bench"
+BASE="bench-base.csv"
+
+echo "Compilation en cours..."
+
+if gcc -O2 -pthread sokoban.c -o "$EXEC"; then
+    echo "Compilation réussie !"
+else
+    echo "Erreur : la compilation a échoué."
+    exit 1
+fi
+
+if [ "$1" = "--base" ] || [ ! -f "$BASE" ]; then
+    echo "Mesure de la base..."
+    ./"$EXEC" --bench > "$BASE" || exit 1
+    echo "Base écrite dans $BASE"
+else
+    echo "Comparaison avec $BASE..."
+    ./"$EXEC" --bench --base "$BASE" > bench-dernier.csv
+fi
@@ -6,7 +6,7 @@ EXEC="sokoban"
 
 echo "Compilation en cours..."
 
-if gcc sokoban.c -o "$EXEC"; then
+if gcc -pthread sokoban.c -o "$EXEC"; then
     echo "Compilation réussie !"
 else
     echo "Erreur : la compilation a échoué."
@@ -2,8 +2,8 @@
  * @file sokoban.c
  * @brief jeu du Sokoban en C
  * @author Titouan Moquet
- * @version V2.3.7
- * @date 30/11/2025
+ * @version V2.4.24
+ * @date 18/10/2026
  *
  * Jeu du Sokoban réalisé en C jouable dans le terminal dans le cadre de la
  * SAE 1.01, IUT Lannion Info 1D2 2025-2026
@@ -16,15 +16,44 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <termios.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <dirent.h>
+#include <time.h>
 // taille du tableau
-#define TAILLE 12
-#define TAILLE_DEPLACEMENT 5000
+#define TAILLE_MAX 52 // côté maximal du plateau, bord de sentinelles compris
+#define TAILLE_NOM 64 // nom du niveau tapé au clavier, numéro compris
+#define TAILLE_GENERE 12 // côté des niveaux générés par le banc d'essai
+#define TAILLE_DEPLACEMENT 5000 // solutions du solveur
+#define TAILLE_MORCEAU 1024 // déplacements par morceau, multiple de 8
+#define BITS_COUP 3 // direction (2 bits) et poussée (1 bit)
+// octets d'un morceau, plus un pour lire un coup à cheval sur deux octets
+#define OCTETS_MORCEAU (TAILLE_MORCEAU * BITS_COUP / 8 + 1)
+// tailles pour le solveur
+#define MAX_CASES_PLATEAU (TAILLE_MAX * TAILLE_MAX)
+#define MAX_CASES MAX_CASES_PLATEAU // le solveur accepte tout plateau chargé
+#define MAX_CAISSES 32
+#define NB_DIRECTIONS 4
+#define NB_MOTS ((MAX_CASES + 63) / 64)
+#define MAX_SALLES 8
+#define MAX_FENETRE 16
+#define TAILLE_CONSEILS 4096 // puissance de 2
+// nombre maximal de caisses examinées par un test de gel
+#define LIMITE_GEL 64
+// noeuds par tranche de travail de la recherche parallèle
+#define TAILLE_TRANCHE 64
+// recherche sur disque : séquences triées ouvertes à la fois, nom de fichier
+#define MAX_SEQUENCES 64
+#define TAILLE_NOM_DISQUE 1024
 
 // Code d'échappement ANSI (http://www.linuxfocus.org/,
 // https://www.codequoi.com/,
@@ -49,13 +78,355 @@
 #define BG_WHITE "\033[48;5;239m"
 
 /* -- Déclaration de type -- */
-typedef char t_plateau[TAILLE][TAILLE];
-typedef char t_tabDeplacement[TAILLE_DEPLACEMENT];
+// plateau à plat entouré d'une rangée de murs (sentinelles) : case = ligne *
+// largeur + colonne, les dimensions sont celles du niveau chargé, bord compris.
+// Une partie utilise deux plateaux : la couche fixe (plateauBase : BORD, CIBLE
+// ou VIDE) et la couche mobile (plateau : CAISSE, JOUEUR ou VIDE)
+typedef struct {
+  int hauteur;
+  int largeur;
+  char cases[MAX_CASES_PLATEAU];
+  int ciblesLibres; // couche mobile : cibles sans caisse, 0 quand c'est gagné
+  // couche mobile : cases des caisses et, pour chaque case, le numéro de sa
+  // caisse dans caisses (AUCUNE_CASE sans caisse), tenus par deplacer()
+  int nbCaisses;
+  short caisses[MAX_CASES_PLATEAU];
+  short numeroCaisse[MAX_CASES_PLATEAU];
+} t_plateau;
+// historique des déplacements d'une partie, sans limite : morceaux de taille
+// fixe alloués au besoin, 3 bits par coup. Les coups annulés restent après le
+// nombre de déplacements joués, c'est la pile des coups à refaire
+typedef struct {
+  uint8_t **morceaux;
+  int nbMorceaux; // morceaux alloués
+  int capacite;   // taille du tableau des morceaux
+  int nbCoups;    // coups mémorisés, annulés compris
+} t_historique;
+// état de départ gardé en mémoire : recommencer ne relit pas le fichier
+typedef struct {
+  t_plateau plateau; // couche mobile, avec son compte de cibles libres
+  int posJoX;
+  int posJoY;
+  bool perdu;
+} t_depart;
+// niveau d'un fichier : octets de sa première ligne à la fin de la dernière
+typedef struct {
+  size_t debut;
+  size_t fin;
+} t_extrait;
+// fichier de niveaux (un seul niveau ou une collection XSB) projeté en
+// mémoire le temps d'un chargement ; l'index des niveaux n'est construit que
+// jusqu'au niveau demandé
+typedef struct {
+  const char *texte; // contenu du fichier (mmap), NULL s'il est vide
+  size_t taille;
+  size_t lu; // octets déjà parcourus par l'index
+  t_extrait *niveaux;
+  int nbNiveaux;
+  int capacite;
+} t_collection;
+// un bit par case du plateau
+typedef uint64_t t_masque[NB_MOTS];
+
+// salle des cibles : zone avec des cibles reliée au reste du niveau par une
+// seule case
+typedef struct {
+  short entree;
+  t_masque interieur;
+  short ordre[MAX_CAISSES]; // ordre de remplissage des cibles
+  int nbOrdre;
+} t_salle;
+
+// description fixe d'un niveau pour le solveur, les cases sont numérotées à
+// plat : case = ligne * largeur + colonne
+typedef struct {
+  int largeur;
+  int nbCases;
+  int nbMots; // mots des masques couverts par les cases du niveau
+  bool mur[MAX_CASES];
+  bool cible[MAX_CASES];
+  int nbCibles;
+  int decalage[NB_DIRECTIONS]; // haut, bas, gauche, droite
+  // murs en bits, les bits au-delà de la dernière case sont à 1
+  t_masque murs;
+  t_masque cibles;
+  // cases d'où une caisse ne peut plus atteindre aucune cible
+  t_masque casesMortes;
+  // couloirs de largeur 1 : verticaux (AXE_VERTICAL) et horizontaux
+  // (AXE_HORIZONTAL)
+  t_masque tunnels[2];
+  int nbSalles;
+  t_salle salles[MAX_SALLES];
+  // nombre minimal de poussées d'une case jusqu'à chaque cible, à la suite :
+  // nbCases valeurs par cible, la table reste compacte pour un petit niveau
+  int nbListeCibles;
+  short listeCibles[MAX_CAISSES];
+  short distanceCible[MAX_CAISSES * MAX_CASES];
+  // clés de Zobrist : une clé par case pour une caisse et pour le joueur
+  uint64_t zobristCaisse[MAX_CASES];
+  uint64_t zobristJoueur[MAX_CASES];
+} t_niveau;
+
+// position de travail du solveur : plateau à plat sans le joueur
+typedef struct {
+  char cases[MAX_CASES]; // BORD, CAISSE ou VIDE, les cibles sont dans t_niveau
+  short caisses[MAX_CAISSES]; // triées par numéro de case
+  int nbCaisses;
+  int joueur;
+  uint64_t cleCaisses; // XOR des clés de Zobrist des caisses
+  t_masque bitsCaisses; // les mêmes caisses, un bit par case
+} t_position;
+
+// un noeud de la recherche = une position atteinte par une poussée
+typedef struct {
+  int parent;     // -1 pour la position de départ
+  short depart;   // case de la caisse avant la poussée
+  short arrivee;  // case de la caisse après la poussée
+  short joueur;   // plus petite case atteignable par le joueur
+  short poussees; // nombre de poussées depuis le départ
+} t_noeud;
+
+typedef struct {
+  short depart;
+  short arrivee;
+  short joueur; // case du joueur après le coup
+  short cout;   // nombre de poussées, plus de 1 pour un macro-coup
+} t_poussee;
+
+// affectation caisses -> cibles de coût minimal (méthode hongroise), les
+// lignes et les colonnes sont numérotées à partir de 1
+typedef struct {
+  int n;
+  short caseLigne[MAX_CAISSES + 1];  // case de la caisse de chaque ligne
+  int ligneColonne[MAX_CAISSES + 1]; // ligne affectée à chaque colonne
+  int u[MAX_CAISSES + 1];            // potentiels des lignes
+  int v[MAX_CAISSES + 1];            // potentiels des colonnes
+} t_appariement;
+
+// liste ouverte de A* : un seau par valeur de f
+typedef struct {
+  int noeud;
+  int poussees;
+} t_entree;
+
+typedef struct {
+  t_entree *entrees;
+  int nb;
+  int capacite;
+} t_seau;
+
+// table de transposition à adressage ouvert : clé de Zobrist -> noeud
+typedef struct {
+  uint64_t *cles; // 0 = alvéole vide
+  int *valeurs;
+  size_t taille;  // puissance de 2
+  size_t nbEntrees;
+} t_table;
+
+typedef struct {
+  t_niveau niveau;
+  int nbCaisses;
+  t_noeud *noeuds;
+  short *caisses; // nbCaisses cases par noeud
+  int nbNoeuds;
+  int capacite;
+  int maxNoeuds; // limite fixée par la mémoire autorisée
+  t_table table;
+  long noeudsDeveloppes;
+  bool memoirePleine;
+  bool macros; // macro-coups des tunnels et des salles (A* seulement)
+  const bool *arret; // interrompt A* si non NULL et VRAI, atomique
+  long echeance;     // heure limite de A* en ms (maintenant_ms()), 0 sinon
+  bool horsDelai;    // A* arrêté par l'échéance
+} t_solveur;
+
+// tranche [debut, fin[ des noeuds d'une couche à développer
+typedef struct {
+  int debut;
+  int fin;
+} t_tranche;
+
+// pile de tranches d'un thread : le propriétaire prend en bas, les autres
+// volent en haut
+typedef struct {
+  t_tranche *tranches;
+  int haut;
+  int bas;
+  int capacite;
+  pthread_mutex_t verrou;
+} t_deque;
+
+// données partagées par les threads de la recherche parallèle
+typedef struct {
+  t_solveur *solveur;
+  t_deque *deques;
+  int nbThreads;
+  pthread_barrier_t barriere;
+  int debutCouche;
+  int finCouche;
+  int but;     // premier noeud gagnant trouvé, atomique
+  bool arret;  // solution ou mémoire pleine : abandonner la couche, atomique
+  bool fini;   // plus de couche à développer, écrit entre les barrières
+} t_parallele;
+
+// position commune aux recherches en avant et en arrière
+typedef struct {
+  int avant;    // noeud de la recherche en avant
+  int arriere;  // noeud de la recherche en arrière
+  int poussees; // longueur de la solution
+} t_rencontre;
+
+typedef struct {
+  t_parallele *partage;
+  int numero;
+  t_position position; // copie de travail propre au thread
+} t_travailleur;
+
+// recherche sur disque : un enregistrement est fait des caisses triées et du
+// joueur normalisé (la clé) puis de la poussée qui y mène (départ, arrivée)
+typedef struct {
+  const char *dossier; // dossier des fichiers temporaires
+  int processus;       // numéro du processus, dans les noms de fichiers
+  int nbCaisses;
+  int taille;    // valeurs par enregistrement
+  int tailleCle; // valeurs de la clé
+  short *tampon; // enregistrements en attente de tri
+  size_t nbTampon;
+  size_t capaciteTampon;
+  int nbSequences; // séquences triées écrites pour la couche en cours
+} t_disque;
+
+// cache de transposition de IDA* : une alvéole par clé, sans chaînage
+typedef struct {
+  uint64_t cle;
+  int iteration; // itération de IDA* qui a écrit l'alvéole
+  int poussees;
+} t_alveole;
+
+typedef struct {
+  t_alveole *alveoles;
+  size_t taille; // puissance de 2, 0 si pas de cache
+} t_cache;
+
+// état de IDA* : une seule position de travail, modifiée en place
+typedef struct {
+  const t_niveau *niveau;
+  t_position *position;
+  t_appariement appariement;
+  short *depart; // poussées du chemin en cours
+  short *arrivee;
+  int seuil;
+  int prochainSeuil;
+  int iteration;
+  long noeudsDeveloppes;
+  t_cache cache;
+  bool macros;
+  int nbCoups;   // longueur du chemin trouvé, en coups
+  long echeance; // heure limite en ms (maintenant_ms()), 0 sinon
+  bool horsDelai;
+} t_ida;
+
+// recherche locale de l'optimisation d'une solution : une fenêtre de
+// poussées est rejouée autrement pour arriver aux mêmes caisses
+typedef struct {
+  const t_niveau *niveau;
+  t_position *position;
+  t_masque buts;    // caisses à la fin de la fenêtre
+  int suivant;      // case d'où part la poussée suivante, AUCUNE_CASE si fin
+  int maxPoussees;
+  short depart[MAX_FENETRE]; // poussées du chemin en cours
+  short arrivee[MAX_FENETRE];
+  short meilleurDepart[MAX_FENETRE];
+  short meilleurArrivee[MAX_FENETRE];
+  int nbMeilleur;
+  int meilleurCout; // déplacements de la meilleure suite connue
+  bool ameliore;
+  long noeudsDeveloppes;
+} t_fenetre;
+
+// conseil du cache des indices : poussée à jouer depuis une position
+typedef struct {
+  uint64_t cle; // clé de la position, 0 = alvéole vide
+  short depart;
+  short arrivee;
+} t_conseil;
+
+// moteur d'indices du jeu : un thread cherche pendant que le joueur joue
+typedef struct {
+  pthread_t thread;
+  pthread_mutex_t verrou;
+  pthread_cond_t signal;
+  const t_niveau *niveau;
+  t_plateau plateau;   // position à chercher
+  uint64_t cleDemande; // clé de la dernière position demandée
+  uint64_t cleEnCours; // clé de la position cherchée par le thread
+  uint64_t cleEchec;   // dernière position sans solution trouvée
+  bool demande;        // une position attend le thread
+  bool enCours;        // le thread cherche
+  bool arret;          // interrompt la recherche en cours, atomique
+  bool fin;            // arrêt du thread
+  bool nouveau;        // réponse arrivée, l'affichage doit être refait
+  int etat;            // INDICE_AUCUN, INDICE_CALCUL, INDICE_TROUVE ou
+                       // INDICE_IMPOSSIBLE
+  t_conseil conseil;   // conseil affiché
+  t_conseil conseils[TAILLE_CONSEILS];
+} t_indice;
+
+// options du mode sans affichage
+typedef struct {
+  char *fichier;
+  long memoireMo; // mémoire maximale du solveur en Mo
+  int algorithme; // ALGO_LARGEUR, ALGO_ASTAR, ALGO_BIDIRECTIONNEL,
+                  // ALGO_DISQUE ou ALGO_IDA
+  int nbThreads;  // recherche en largeur parallèle si > 1
+  char *dossier;  // recherche sur disque dans ce dossier si non NULL
+  long cacheMo;   // cache de transposition de IDA* en Mo, 0 sans cache
+  bool macros;    // macro-coups pour A* et IDA*
+  char *deplacements; // fichier .dep à raccourcir, NULL pour résoudre
+  int fenetre;        // poussées par fenêtre de l'optimisation
+  long tempsMax;      // secondes par niveau ou par recherche, 0 sans limite
+  char *base;         // CSV de référence de --bench, NULL sans comparaison
+  char *compact;      // solution aussi écrite dans ce fichier .dpk si non NULL
+} t_options;
+
+// résultat d'un niveau de --solve-all, une ligne du CSV
+typedef struct {
+  const char *statut; // STATUT_RESOLU, STATUT_TEMPS...
+  int deplacements;
+  int poussees;
+  long noeuds;
+  int etats;        // positions gardées dans la table
+  long tempsMs;     // temps total du niveau
+  long rechercheUs; // temps jusqu'à la fin de la recherche
+  long memoireKo;
+} t_resultat;
+
+// niveaux d'un dossier résolus par plusieurs threads
+typedef struct {
+  const t_options *options;
+  char **fichiers; // noms des fichiers .sok, triés
+  int nbFichiers;
+  int suivant; // prochain niveau à prendre, atomique
+  t_resultat *resultats;
+} t_lot;
+
+// une ligne du CSV du banc d'essai, lue depuis la base
+typedef struct {
+  char niveau[64];
+  char algo[16];
+  char statut[16];
+  int poussees;
+  long noeuds;
+  int etats;
+  long tempsUs;
+  long vitesse; // noeuds développés par seconde
+} t_mesure;
 
 /* -- Déclaration des constantes --*/
 // touches
 const char HAUT = 'z', BAS = 's', GAUCHE = 'q', DROITE = 'd';
-const char RELOAD = 'r', FIN = 'x', UNDO = 'u';
+const char RELOAD = 'r', FIN = 'x', UNDO = 'u', REDO = 'y';
+const char INDICE = 'i';
 // murs et chaisses
 const char BORD = '#', OBJECTIF = '*', CAISSE = '$';
 // joueur
@@ -92,146 +463,527 @@ const char QUITTER[6] = "exit"; // pour quitter le jeu lors du choix des niveau
 const char TOUCHE_NULL = '\0';  // touche 'null'
 
 const char FICHIER_SOK[] = ".sok";
+const char FICHIER_COLLECTION[] = ".xsb"; // plusieurs niveaux par fichier
+const char SEPARATEUR_NIVEAU = ':'; // collection.xsb:12, douzième niveau
+const char COMMENTAIRE = ';';       // ligne de titre d'une collection
+// caractères d'une rangée de niveau, '-' et '_' sont des cases vides (XSB)
+const char CARACTERES_PLATEAU[] = "#@+$*. -_";
 const char FICHIER_DEP[] = ".dep";
+const char FICHIER_DEP_COMPACT[] = ".dpk"; // déplacements sur 3 bits
+const char ENTETE_COMPACT[] = "DEP3";      // début d'un fichier .dpk
+// caractère de chaque code sur 3 bits : direction de direction_deplacement(),
+// plus NB_DIRECTIONS pour une poussée
+const char CARACTERES_COUPS[] = "hbgdHBGD";
+
+// options de la ligne de commande
+const char OPTION_RESOLUTION[] = "--solve";
+const char OPTION_MEMOIRE[] = "--memoire";
+const char OPTION_ASTAR[] = "--astar";
+const char OPTION_THREADS[] = "--threads";
+const char OPTION_BIDIRECTIONNEL[] = "--bidir";
+const char OPTION_DISQUE[] = "--disque";
+const char OPTION_IDA[] = "--ida";
+const char OPTION_CACHE[] = "--cache";
+const char OPTION_MACROS[] = "--macros";
+const char OPTION_OPTIMISATION[] = "--optimise";
+const char OPTION_RESOLUTION_DOSSIER[] = "--solve-all";
+const char OPTION_TEMPS[] = "--temps";
+const long TEMPS_DEFAUT = 60; // secondes par niveau
+const char STATUT_RESOLU[] = "resolu";
+const char STATUT_SANS_SOLUTION[] = "sans_solution";
+const char STATUT_TEMPS[] = "temps";
+const char STATUT_MEMOIRE[] = "memoire";
+const char STATUT_INVALIDE[] = "invalide";
+const char STATUT_TROP_LONG[] = "trop_long";
+const char STATUT_TROP_GRAND[] = "trop_grand";
+const char OPTION_BANC[] = "--bench";
+const char OPTION_BASE[] = "--base";
+const char OPTION_COMPACT[] = "--compact";
+const long MEMOIRE_BANC = 64;        // Mo par recherche
+const long TEMPS_BANC = 10;          // secondes par recherche
+const int NB_NIVEAUX_BANC = 7;       // niveau1.sok à niveau7.sok
+const int NB_SYNTHETIQUES = 8;       // niveaux générés
+const uint64_t GRAINE_BANC = 0xba5eba11ULL;
+const int TIRAGES_BANC = 60;         // tirages au hasard par niveau généré
+const long DUREE_MESURE_US = 100000; // vitesse comparée au-delà de 0,1 s
+const long SEUIL_REGRESSION = 10;    // baisse de vitesse tolérée en %
+const char OPTION_FENETRE[] = "--fenetre";
+const int FENETRE_DEFAUT = 8;
+const int INDICE_AUCUN = 0;
+const int INDICE_CALCUL = 1;
+const int INDICE_TROUVE = 2;
+const int INDICE_IMPOSSIBLE = 3;
+const long MEMOIRE_INDICE = 64; // Mo
+const int ALGO_LARGEUR = 0;
+const int ALGO_ASTAR = 1;
+const int ALGO_BIDIRECTIONNEL = 2;
+const int ALGO_DISQUE = 3;
+const int ALGO_IDA = 4;
+const int INFINI_DISTANCE = 10000;
+const int AUCUNE_CASE = -1;
+const int AXE_VERTICAL = 0;
+const int AXE_HORIZONTAL = 1;
+// valeurs d'alvéole de la table partagée : noeud pas encore écrit, abandonné
+const int NOEUD_EN_COURS = -1;
+const int NOEUD_ABSENT = -2;
+const int CAPACITE_INITIALE = 1 << 16;
+const long MEMOIRE_DEFAUT = 512; // Mo
+const uint64_t GRAINE_ZOBRIST = 0x50b0ba2025ULL;
 
 // Les prototypes des fonctions et procédures, détaille avant chaque fonction
 // et procédures.
 
 int kbhit();
-void init_game(t_plateau plateau, t_plateau plateauBase, char *jouer,
-  int *nbDeplacement, char nomNiveau[], int *comparaison,
-  int *posJoX, int *posJoY, bool errorPosJo, bool *gagner);
-bool verif_peu_jouer(char touche, bool gagner, 
-  int nbDeplacement, bool errorPosJo,int notExit);
-void charger_partie(t_plateau plateau, char fichier[]);
-void enregistrer_partie(t_plateau plateau, char fichier[]);
-void sauvegarde_jeu(t_plateau plateau);
-void sauvegarde_deplacements(t_tabDeplacement tabDeplacement,
-  int nbDeplacement);
-void enregistrer_deplacements(t_tabDeplacement t, int nb, char fic[]);
+void init_game(t_plateau *plateau, t_plateau *plateauBase, t_niveau *niveau,
+  char *jouer, int *nbDeplacement, char nomNiveau[], int *comparaison,
+  int *posJoX, int *posJoY, bool *errorPosJo, bool *gagner,
+  t_depart *depart);
+void recommencer(const t_depart *depart, t_plateau *plateau, int *posJoX,
+  int *posJoY, bool *perdu);
+bool verif_peu_jouer(char touche, bool gagner, bool errorPosJo,
+  int notExit);
+void charger_partie(t_plateau *plateau, char fichier[]);
+bool lire_niveau(t_plateau *plateau, const char fichier[]);
+int numero_niveau(const char *fichier, char nom[], size_t taille);
+bool ouvrir_collection(const char *fichier, t_collection *collection);
+void fermer_collection(t_collection *collection);
+bool indexer_collection(t_collection *collection, int numero);
+size_t ligne_suivante(const t_collection *collection, size_t position);
+bool ligne_plateau(const char *ligne, size_t longueur);
+void separer_couches(t_plateau *plateau, t_plateau *plateauBase);
+void indexer_caisses(t_plateau *plateau);
+void bouger_caisse(t_plateau *plateau, t_plateau *plateauBase, int depart,
+  int arrivee);
+char caractere_case(char mobile, char fixe);
+void enregistrer_partie(t_plateau *plateau, t_plateau *plateauBase,
+  char fichier[]);
+void sauvegarde_jeu(t_plateau *plateau, t_plateau *plateauBase);
+void sauvegarde_deplacements(t_historique *historique, int nbDeplacement);
+void enregistrer_deplacements(t_historique *historique, int nb, char fic[]);
+void ecrire_historique(const t_historique *historique, int nb, FILE *f);
+void ecrire_compact(const t_historique *historique, int nb, FILE *f);
+bool fichier_compact(const char *fic);
+int code_coup(char coup);
+int lire_code(const uint8_t octets[], int indice);
+void ecrire_code(uint8_t octets[], int indice, int code);
+void init_historique(t_historique *historique);
+void liberer_historique(t_historique *historique);
+void couper_historique(t_historique *historique, int nb);
+void ecrire_coup(t_historique *historique, int indice, char coup);
+char coup_historique(const t_historique *historique, int indice);
+char touche_refaire(const t_historique *historique, int nbDeplacement);
 void afficher_entete(int nbDeplacement, char nomNiveau[]);
-void affiche_plateau(t_plateau plateau, int niveauZoom);
-void affiche_plateau_largeur(t_plateau plateau, int niveauZoom, int longueur);
+void affiche_plateau(t_plateau *plateau, t_plateau *plateauBase,
+  int niveauZoom);
+void affiche_plateau_largeur(t_plateau *plateau, t_plateau *plateauBase,
+  int niveauZoom, int longueur);
 void affiche_debut();
-void affichage_complet(t_plateau plateau, t_tabDeplacement tabDeplacement,
-  char nomNiveau[], int nbDeplacement, int niveauZoom,
-  bool errorPosJo);
-void recherche_pos_jo(t_plateau plateau, int *posJoX, int *posJoY);
-void deplacer(t_plateau plateau, t_plateau plateauBase,
-  t_tabDeplacement tabDeplacement, char touche, int *posJoX,
-  int *posJoY, int *nbDeplacement);
-void deplacer_joueur(t_plateau plateau, t_plateau plateauBase, int directionX,
-  int directionY);
-void remplace_caractere(t_plateau tableau, t_plateau plateauBase, int posX,
-  int posY);
-void annuler_deplacement(t_plateau plateau, t_plateau plateauBase,
-  t_tabDeplacement tabDeplacement, int *posJoX,
+void affichage_complet(t_plateau *plateau, t_plateau *plateauBase,
+  t_historique *historique, char nomNiveau[], int nbDeplacement,
+  int niveauZoom, bool errorPosJo);
+void recherche_pos_jo(t_plateau *plateau, int *posJoX, int *posJoY);
+void deplacer(t_plateau *plateau, t_plateau *plateauBase,
+  t_historique *historique, char touche, int *posJoX,
   int *posJoY, int *nbDeplacement);
-bool gagne(t_plateau plateau, t_plateau plateauBase);
+void annuler_deplacement(t_plateau *plateau, t_plateau *plateauBase,
+  t_historique *historique, int *posJoX, int *posJoY,
+  int *nbDeplacement);
+bool gagne(t_plateau *plateau);
+int compter_cibles_libres(t_plateau *plateau, t_plateau *plateauBase);
 void affiche_message_fin(int nbDeplacement);
 void affiche_abandon();
 void affiche_niveau();
-void jeu(char touche, t_plateau plateau, t_plateau plateauBase,
-  t_tabDeplacement tabDeplacement, int *posJoX, int *posJoY,
+void jeu(char touche, t_plateau *plateau, t_plateau *plateauBase,
+  t_historique *historique, int *posJoX, int *posJoY,
   int *nbDeplacement, char nomNiveau[], int *niveauZoom, bool *gagner,
-  bool errorPosJo);
-void memoriser_deplacement(char touche, t_tabDeplacement tabDeplacement,
+  bool errorPosJo, const t_niveau *niveau, bool *perdu, t_indice *indice,
+  const t_depart *depart);
+bool deplacement_avec_caisse(char c);
+bool caisse_perdue(t_plateau *plateau, const t_niveau *niveau, int ligne,
+  int colonne);
+bool plateau_perdu(t_plateau *plateau, const t_niveau *niveau);
+void affiche_blocage();
+void init_indice(t_indice *indice, const t_niveau *niveau);
+void liberer_indice(t_indice *indice);
+void vider_indice(t_indice *indice);
+void demander_indice(t_indice *indice, t_plateau *plateau);
+void oublier_indice(t_indice *indice);
+bool indice_nouveau(t_indice *indice);
+void afficher_indice(t_indice *indice);
+void *chercher_indices(void *argument);
+void noter_conseils(t_indice *indice, t_position *position,
+  const short depart[], const short arrivee[], int nbPoussees);
+void memoriser_deplacement(char touche, t_historique *historique,
   int leDeplacement, int nbDeplacement);
-void affiche_tab_dep(t_tabDeplacement tabDeplacement, int nbDeplacement);
+void affiche_tab_dep(t_historique *historique, int nbDeplacement);
 void rejouer(char *touche, char *jouer, bool gagner);
-void affiche_erreur();
 char get_touche_y_n();
+// solveur
+bool lire_options(int argc, char *argv[], t_options *options);
+int resoudre_fichier(const t_options *options);
+int optimiser_fichier(const t_options *options);
+int resoudre_dossier(const t_options *options);
+int lister_niveaux(const char *dossier, char ***fichiers);
+int comparer_noms(const void *a, const void *b);
+void *travailleur_lot(void *argument);
+void resoudre_niveau(const t_options *options, const char *nom,
+  t_resultat *resultat);
+void resoudre_plateau(t_plateau *plateau, t_plateau *plateauBase,
+  const t_options *options, int algorithme, t_resultat *resultat);
+long maintenant_ms();
+long maintenant_us();
+int lancer_banc(const t_options *options);
+void generer_niveau(uint64_t graine, t_plateau *plateau,
+  t_plateau *plateauBase);
+int ecrire_mesure(const char *nom, int algorithme, const t_resultat *resultat,
+  const t_mesure *base, int nbBase);
+int lire_base(const char *fichier, t_mesure **base);
+size_t memoire_solveur(const t_solveur *solveur);
+int lire_deplacements(t_historique *historique, char fic[]);
+int direction_deplacement(char c);
+int extraire_deplacements(t_position *position, const t_niveau *niveau,
+  const t_historique *historique, int nb, short depart[], short arrivee[]);
+int optimiser_poussees(t_position *position, const t_niveau *niveau,
+  short depart[], short arrivee[], int nbPoussees, int taille,
+  long *noeudsDeveloppes);
+int cout_fenetre(const t_position *position, const t_niveau *niveau,
+  const short depart[], const short arrivee[], int nb, int suivant);
+void distances_joueur(const t_position *position, const t_niveau *niveau,
+  short distance[]);
+void explorer_fenetre(t_fenetre *fenetre, int profondeur, int cout);
+bool analyser_niveau(t_plateau *plateau, t_plateau *plateauBase,
+  t_niveau *niveau);
+uint64_t alea_zobrist(uint64_t *graine);
+void calculer_cases_mortes(t_niveau *niveau);
+void calculer_tunnels(t_niveau *niveau);
+void calculer_salles(t_plateau *plateau, t_niveau *niveau);
+bool ordre_salle(const t_niveau *niveau, t_salle *salle);
+bool masque_contient_un(const t_masque a, const t_masque b, int nbMots);
+void position_vide(const t_niveau *niveau, t_position *position);
+void ajouter_caisse(t_position *position, const t_niveau *niveau,
+  int laCase);
+int chemin_caisse(t_position *position, const t_niveau *niveau, int depart,
+  int arrivee, short chemin[]);
+void etendre_macros(t_position *position, const t_niveau *niveau,
+  t_poussee poussees[], int nbPoussees);
+void etendre_tunnel(const t_position *position, const t_niveau *niveau,
+  t_poussee *poussee);
+void entrer_salle(t_position *position, const t_niveau *niveau,
+  const t_salle *salle, t_poussee *poussee);
+int developper_macros(t_plateau *plateau, const t_niveau *niveau,
+  short depart[], short arrivee[], int nbCoups);
+bool poussee_simple(const t_niveau *niveau, int depart, int arrivee);
+void calculer_distances(t_niveau *niveau);
+bool masque_contient(const t_masque masque, int laCase);
+void masque_ajouter(t_masque masque, int laCase);
+void masque_retirer(t_masque masque, int laCase);
+int masque_premiere_case(const t_masque masque, int nbMots);
+void inonder_masque(const t_masque libre, t_masque zone, int largeur,
+  int nbMots);
+void init_position(t_plateau *plateau, const t_niveau *niveau,
+  t_position *position);
+bool est_caisse(char c);
+bool est_libre(char c);
+void placer_etat(t_position *position, const t_niveau *niveau,
+  const short caisses[], int joueur);
+void pousser_caisse(t_position *position, const t_niveau *niveau, int depart,
+  int arrivee);
+int acces_joueur(const t_position *position, const t_niveau *niveau,
+  t_masque atteint);
+bool blocage_gel(const char cases[], const t_niveau *niveau, int caisse);
+bool corral_pi(const t_position *position, const t_niveau *niveau,
+  const t_masque atteint, t_masque cloture);
+int racine_region(int parent[], int region);
+bool caisse_gelee(const char cases[], const t_niveau *niveau, int caisse,
+  short pile[], int *nbPile, int *budget, bool *horsCible);
+bool axe_bloque(const char cases[], const t_niveau *niveau, int caisse,
+  int decalage, short pile[], int *nbPile, int *budget, bool *horsCible);
+bool position_gagnante(const t_position *position, const t_niveau *niveau);
+bool init_solveur(t_solveur *solveur, const t_niveau *niveau, int nbCaisses,
+  long memoireMo);
+void liberer_solveur(t_solveur *solveur);
+bool init_table(t_table *table, size_t taille);
+void liberer_table(t_table *table);
+uint64_t cle_position(const t_position *position, const t_niveau *niveau);
+int ajouter_noeud(t_solveur *solveur, const t_position *position, int parent,
+  int depart, int arrivee, bool *nouveau);
+int lister_poussees(const t_position *position, const t_niveau *niveau,
+  const t_masque atteint, t_poussee poussees[]);
+bool jouer_poussee(t_position *position, const t_niveau *niveau,
+  t_poussee poussee);
+void annuler_poussee(t_position *position, const t_niveau *niveau,
+  t_poussee poussee);
+int recherche_largeur(t_solveur *solveur, t_position *position);
+bool hors_delai(t_solveur *solveur);
+int recherche_parallele(t_solveur *solveur, t_position *position,
+  int nbThreads);
+void *travailleur_largeur(void *argument);
+void distribuer_couche(t_parallele *partage);
+bool prendre_tranche(t_parallele *partage, int numero, t_tranche *tranche);
+int ajouter_noeud_partage(t_parallele *partage, const t_position *position,
+  int parent, int depart, int arrivee, bool *nouveau);
+bool agrandir_noeuds(t_solveur *solveur, int capacite);
+bool recherche_bidirectionnelle(t_solveur *avant, t_solveur *arriere,
+  t_position *position, t_rencontre *rencontre);
+bool developper_couche(t_solveur *solveur, const t_solveur *autre,
+  t_position *position, bool tirer, int debut, t_rencontre *rencontre);
+void noter_rencontre(const t_solveur *avant, const t_solveur *arriere,
+  int noeudAvant, int noeudArriere, t_rencontre *rencontre);
+int lister_tirages(const t_position *position, const t_niveau *niveau,
+  const t_masque atteint, t_poussee tirages[]);
+void tirer_caisse(t_position *position, const t_niveau *niveau,
+  t_poussee tirage);
+int chercher_noeud(const t_solveur *solveur, const t_position *position);
+int extraire_rencontre(const t_solveur *avant, const t_solveur *arriere,
+  const t_rencontre *rencontre, short depart[], short arrivee[]);
+int recherche_disque(const t_niveau *niveau, t_position *position,
+  const char *dossier, long memoireMo, long echeance, short depart[],
+  short arrivee[], long *noeudsDeveloppes, bool *horsDelai);
+void init_disque(t_disque *disque, const char *dossier, int nbCaisses,
+  long memoireMo);
+void liberer_disque(t_disque *disque, int nbCouches);
+void nom_disque(const t_disque *disque, const char *sorte, int numero,
+  char nom[]);
+FILE *ouvrir_disque(const char *nom, const char *mode);
+void ecrire_disque(const short valeurs[], int nb, FILE *f);
+void fermer_disque(FILE *f);
+int comparer_cles(const short a[], const short b[], int tailleCle);
+void ajouter_tampon(t_disque *disque, const short enregistrement[]);
+void vider_tampon(t_disque *disque);
+void tamiser(t_disque *disque, size_t i, size_t nb);
+void echanger_enregistrements(short a[], short b[], int taille);
+void fusionner_sequences(t_disque *disque);
+long retirer_vues(t_disque *disque, int profondeur);
+int remonter_disque(const t_disque *disque, const t_niveau *niveau,
+  t_position *position, short but[], int profondeur, short depart[],
+  short arrivee[]);
+bool chercher_disque(FILE *f, int taille, int tailleCle, const short cle[],
+  short enregistrement[]);
+int recherche_ida(const t_niveau *niveau, t_position *position, long cacheMo,
+  bool macros, long echeance, short depart[], short arrivee[],
+  long *noeudsDeveloppes, bool *horsDelai);
+bool explorer_ida(t_ida *ida, int poussees, int coups);
+void init_cache(t_cache *cache, long cacheMo);
+bool noter_cache(t_cache *cache, uint64_t cle, int poussees, int iteration);
+int ecrire_solution(t_plateau *plateau, t_plateau *plateauBase,
+  const t_niveau *niveau, short depart[], short arrivee[], int nbPoussees,
+  const char *fichier, const char *compact, long noeudsDeveloppes);
+int cout_appariement(const t_niveau *niveau, const t_appariement *appariement,
+  int ligne, int colonne);
+void calculer_appariement(const t_niveau *niveau, const t_position *position,
+  t_appariement *appariement);
+void augmenter_ligne(const t_niveau *niveau, t_appariement *appariement,
+  int ligne);
+void deplacer_appariement(const t_niveau *niveau, t_appariement *appariement,
+  int depart, int arrivee);
+int valeur_appariement(const t_niveau *niveau,
+  const t_appariement *appariement);
+bool empiler_seau(t_seau *seau, int noeud, int poussees);
+bool ajouter_seau(t_seau **seaux, int *nbSeaux, int f, int noeud,
+  int poussees);
+int recherche_astar(t_solveur *solveur, t_position *position);
+int extraire_poussees(const t_solveur *solveur, int noeud, short depart[],
+  short arrivee[]);
+bool construire_deplacements(t_plateau *plateau, t_plateau *plateauBase,
+  const t_niveau *niveau, short depart[], short arrivee[], int nbPoussees,
+  t_historique *historique, int *nbDeplacement);
+bool chemin_joueur(t_plateau *plateau, t_plateau *plateauBase, int depX,
+  int depY, int arrX, int arrY, char touches[], int *nbTouches);
+char touche_direction(int direction);
 
 /**
  * @brief Entrée du programme
+ * @param argc nombre d'arguments
+ * @param argv arguments, "--solve niveau.sok [--memoire Mo] [--astar]
+ * [--threads N] [--bidir] [--disque dossier] [--ida [--cache Mo]]
+ * [--macros] [--temps s] [--compact f.dpk]" lance le solveur sans affichage,
+ * "--optimise niveau.sok solution.dep [--fenetre N] [--compact f.dpk]"
+ * raccourcit une solution, "--solve-all dossier [--threads N] [--memoire Mo]
+ * [--temps s]" résout tout un dossier, "--bench
+ * [--base fichier.csv] [--memoire Mo] [--temps s]" lance le banc d'essai
  * @return EXIT_SUCCESS : arrêt normal du programme
  * Fait appel à toutes les procedures et fonctions necessaires au jeu.
  */
-int main() {
+int main(int argc, char *argv[]) {
+  // mode sans affichage : résolution automatique d'un niveau
+  if ((argc >= 2) && (strcmp(argv[1], OPTION_RESOLUTION) == 0)) {
+    t_options options;
+    if (!lire_options(argc, argv, &options)) {
+      fprintf(stderr,
+              "usage : %s %s niveau.sok [%s Mo] [%s] [%s N] [%s] [%s "
+              "dossier] [%s [%s Mo]] [%s] [%s s] [%s fichier.dpk]\n",
+              argv[0], OPTION_RESOLUTION, OPTION_MEMOIRE, OPTION_ASTAR,
+              OPTION_THREADS, OPTION_BIDIRECTIONNEL, OPTION_DISQUE,
+              OPTION_IDA, OPTION_CACHE, OPTION_MACROS, OPTION_TEMPS,
+              OPTION_COMPACT);
+      return EXIT_FAILURE;
+    }
+    return resoudre_fichier(&options);
+  }
+  // mode sans affichage : raccourcir une liste de déplacements
+  if ((argc >= 2) && (strcmp(argv[1], OPTION_OPTIMISATION) == 0)) {
+    t_options options;
+    if (!lire_options(argc, argv, &options)) {
+      fprintf(stderr,
+              "usage : %s %s niveau.sok solution.dep [%s N] [%s "
+              "fichier.dpk]\n",
+              argv[0], OPTION_OPTIMISATION, OPTION_FENETRE, OPTION_COMPACT);
+      return EXIT_FAILURE;
+    }
+    return optimiser_fichier(&options);
+  }
+  // mode sans affichage : tous les niveaux d'un dossier, résultats en CSV
+  if ((argc >= 2) && (strcmp(argv[1], OPTION_RESOLUTION_DOSSIER) == 0)) {
+    t_options options;
+    if (!lire_options(argc, argv, &options)) {
+      fprintf(stderr, "usage : %s %s dossier [%s N] [%s Mo] [%s s]\n",
+              argv[0], OPTION_RESOLUTION_DOSSIER, OPTION_THREADS,
+              OPTION_MEMOIRE, OPTION_TEMPS);
+      return EXIT_FAILURE;
+    }
+    return resoudre_dossier(&options);
+  }
+  // mode sans affichage : banc d'essai du solveur, mesures en CSV
+  if ((argc >= 2) && (strcmp(argv[1], OPTION_BANC) == 0)) {
+    t_options options;
+    if (!lire_options(argc, argv, &options)) {
+      fprintf(stderr, "usage : %s %s [%s fichier.csv] [%s Mo] [%s s]\n",
+              argv[0], OPTION_BANC, OPTION_BASE, OPTION_MEMOIRE,
+              OPTION_TEMPS);
+      return EXIT_FAILURE;
+    }
+    return lancer_banc(&options);
+  }
   // Declaration des variables
   t_plateau plateau, plateauBase;
-  t_tabDeplacement tabDeplacement;
+  t_niveau niveau; // analyse du niveau faite une fois au chargement
+  t_historique historique; // déplacements joués, et annulés à refaire
+  t_indice indice; // indices calculés en fond pendant la partie
+  t_depart depart; // état initial, pour recommencer sans relire le fichier
   int posJoX, posJoY, nbDeplacement, niveauZoom = 1, comparaison;
-  char nomNiveau[20], touche, jouer = YES;
+  char nomNiveau[TAILLE_NOM], touche, jouer = YES;
   // Initialisation des données
   bool gagner = FAUX, errorPosJo = FAUX;
+  bool perdu = FAUX; // une caisse ne peut plus atteindre de cible
   touche = TOUCHE_NULL;
   posJoX = 0;
   posJoY = 0;
   bool peuJouer;
   system("clear");
+  init_indice(&indice, &niveau);
+  init_historique(&historique);
   while (jouer != NO) {
-    init_game(plateau, plateauBase, &jouer, &nbDeplacement, nomNiveau,
-      &comparaison, &posJoX, &posJoY, errorPosJo, &gagner);
-      peuJouer = verif_peu_jouer(touche, gagner, nbDeplacement, 
-      errorPosJo, comparaison);
+    vider_indice(&indice);
+    couper_historique(&historique, 0);
+    init_game(&plateau, &plateauBase, &niveau, &jouer, &nbDeplacement,
+      nomNiveau, &comparaison, &posJoX, &posJoY, &errorPosJo, &gagner,
+      &depart);
+    perdu = (comparaison != 0) && plateau_perdu(&plateau, &niveau);
+    depart.perdu = perdu;
+      peuJouer = verif_peu_jouer(touche, gagner, errorPosJo, comparaison);
     while (peuJouer) {
       if (kbhit()) {
         touche = getchar();
-        jeu(touche, plateau, plateauBase, tabDeplacement, &posJoX, &posJoY,
-            &nbDeplacement, nomNiveau, &niveauZoom, &gagner, errorPosJo);
-        affichage_complet(plateau, tabDeplacement, nomNiveau, nbDeplacement,
-          niveauZoom, errorPosJo);
+        jeu(touche, &plateau, &plateauBase, &historique, &posJoX, &posJoY,
+            &nbDeplacement, nomNiveau, &niveauZoom, &gagner, errorPosJo,
+            &niveau, &perdu, &indice, &depart);
+        affichage_complet(&plateau, &plateauBase, &historique, nomNiveau,
+          nbDeplacement, niveauZoom, errorPosJo);
+        if (perdu) {
+          affiche_blocage();
+        }
+        afficher_indice(&indice);
+      } else if (indice_nouveau(&indice)) {
+        // le thread des indices a répondu pendant que le joueur réfléchit
+        affichage_complet(&plateau, &plateauBase, &historique, nomNiveau,
+          nbDeplacement, niveauZoom, errorPosJo);
+        if (perdu) {
+          affiche_blocage();
+        }
+        afficher_indice(&indice);
       }
       if (touche == FIN) {
-        sauvegarde_jeu(plateau);
+        sauvegarde_jeu(&plateau, &plateauBase);
       }
-      peuJouer = verif_peu_jouer(touche, gagner, nbDeplacement, 
-        errorPosJo, comparaison);
-    }
-    if (nbDeplacement >= TAILLE_DEPLACEMENT) {
-      affiche_erreur();
+      peuJouer = verif_peu_jouer(touche, gagner, errorPosJo, comparaison);
     }
     if (gagner == VRAI) {
       system("clear");
-      affiche_plateau(plateau, niveauZoom);
+      affiche_plateau(&plateau, &plateauBase, niveauZoom);
       affiche_message_fin(nbDeplacement);
     }
     if ((comparaison != 0) && (errorPosJo == FAUX)) {
-      sauvegarde_deplacements(tabDeplacement, nbDeplacement);
+      sauvegarde_deplacements(&historique, nbDeplacement);
     }
     rejouer(&touche, &jouer, gagner);
     gagner = FAUX;
   }
+  liberer_indice(&indice);
+  liberer_historique(&historique);
   printf(BOLD YELLOW "\n\nAu revoir !\n" RESET);
   return EXIT_SUCCESS;
 }
 
 // ---- fonctions et procédures ----
-bool verif_peu_jouer(char touche, bool gagner, int nbDeplacement,
-  bool errorPosJo,int notExit) {
+bool verif_peu_jouer(char touche, bool gagner, bool errorPosJo,
+  int notExit) {
   return ((touche != FIN) && (gagner == FAUX) &&
-  (nbDeplacement < TAILLE_DEPLACEMENT) &&
   (errorPosJo == FAUX) && (notExit != 0));
 }
 
 /**
  * @brief procedure pour inititaliser les variables de jeu et des plateaux
  * utiliser pour reduire la taille du main
+ * @param niveau t_niveau, analyse du niveau (cases mortes...), en sortie
+ * @param depart t_depart, copie de l'état initial pour recommencer, en sortie
  */
-void init_game(t_plateau plateau, t_plateau plateauBase, char *jouer,
-    int *nbDeplacement, char nomNiveau[], int *comparaison,
-    int *posJoX, int *posJoY, bool errorPosJo, bool *gagner) {
+void init_game(t_plateau *plateau, t_plateau *plateauBase, t_niveau *niveau,
+    char *jouer, int *nbDeplacement, char nomNiveau[], int *comparaison,
+    int *posJoX, int *posJoY, bool *errorPosJo, bool *gagner,
+    t_depart *depart) {
   *jouer = NO;
   *nbDeplacement = 0;
   affiche_debut();
-  scanf("%s", nomNiveau);
+  scanf("%63s", nomNiveau); // TAILLE_NOM - 1 caractères au plus
   *comparaison = strcmp(nomNiveau, QUITTER);
   if (*comparaison != 0) {
-    // deux plateau, 1 pour le jeu et 1 pour la sauvegarde des élèments
+    // deux couches : murs et cibles fixes, caisses et joueur mobiles
     charger_partie(plateau, nomNiveau);
-    charger_partie(plateauBase, nomNiveau);
+    separer_couches(plateau, plateauBase);
+    analyser_niveau(plateau, plateauBase, niveau);
     recherche_pos_jo(plateau, &(*posJoX), &(*posJoY));
     if ((*posJoX == -1) || (*posJoY == -1)) {
-      errorPosJo = VRAI;
+      // aussi pour un niveau trop grand, chargé sans aucune case
+      *errorPosJo = VRAI;
       printf( RED
         "Erreur sur la position du joueur vérifiez le niveau !\n\n "
       RESET);
+    } else {
+      *gagner = gagne(plateau);
     }
-    *gagner = gagne(plateau, plateauBase);
+    depart->plateau = *plateau;
+    depart->posJoX = *posJoX;
+    depart->posJoY = *posJoY;
   }
 }
 
+/**
+ * @brief Procédure qui remet la partie dans son état initial par une simple
+ * copie, sans relire le fichier ni chercher le joueur.
+ * @param depart t_depart, état initial gardé au chargement
+ * @param plateau t_plateau, couche mobile, en sortie
+ * @param posJoX int, ligne du joueur, en sortie
+ * @param posJoY int, colonne du joueur, en sortie
+ * @param perdu bool, partie perdue dès le départ, en sortie
+ */
+void recommencer(const t_depart *depart, t_plateau *plateau, int *posJoX,
+    int *posJoY, bool *perdu) {
+  *plateau = depart->plateau;
+  *posJoX = depart->posJoX;
+  *posJoY = depart->posJoY;
+  *perdu = depart->perdu;
+}
+
 /**
  * @brief procedure pour confirmer si le joueur veux rejouer ou non
  * @param touche, entrer sortie
@@ -254,31 +1006,51 @@ void rejouer(char *touche, char *jouer, bool gagner) {
  * @param touche char
  * @param plateau t_plateau
  * @param plateauBase t-plateau
+ * @param historique t_historique, déplacements joués et annulés (touches u, y)
  * @param posJoX int
  * @param posJoY int
  * @param nbDeplacement int
  * @param nomNiveau char
  * @param niveauZoom int
  * @param gagner bool
+ * @param niveau t_niveau, analyse du niveau (cases mortes)
+ * @param perdu bool, VRAI si la partie ne peut plus être gagnée, en entrer et
+ * sortie
+ * @param indice t_indice, moteur d'indices (touche i)
+ * @param depart t_depart, état initial (touche r)
  */
-void jeu(char touche, t_plateau plateau, t_plateau plateauBase,
-  t_tabDeplacement tabDeplacement, int *posJoX, int *posJoY,
+void jeu(char touche, t_plateau *plateau, t_plateau *plateauBase,
+  t_historique *historique, int *posJoX, int *posJoY,
   int *nbDeplacement, char nomNiveau[], int *niveauZoom, bool *gagner,
-  bool errorPosJo) {
+  bool errorPosJo, const t_niveau *niveau, bool *perdu, t_indice *indice,
+  const t_depart *depart) {
+  int avant = *nbDeplacement, ancienX = *posJoX, ancienY = *posJoY;
+  // refaire, c'est rejouer la touche du premier coup annulé
+  char coup = (touche == REDO) ? touche_refaire(historique, *nbDeplacement)
+                               : touche;
 
-  deplacer(plateau, plateauBase, tabDeplacement, touche, &(*posJoX),
+  deplacer(plateau, plateauBase, historique, coup, &(*posJoX),
    &(*posJoY), &(*nbDeplacement));
+  if ((*nbDeplacement > avant) &&
+      deplacement_avec_caisse(coup_historique(historique, avant))) {
+    // la caisse poussée est juste devant le joueur ; une partie perdue le
+    // reste tant qu'on n'annule pas
+    *perdu = *perdu || caisse_perdue(plateau, niveau, 2 * *posJoX - ancienX,
+                                     2 * *posJoY - ancienY);
+  }
   if (touche == RELOAD) {
-    charger_partie(plateau, nomNiveau);
-    recherche_pos_jo(plateau, &(*posJoX), &(*posJoY));
+    recommencer(depart, plateau, &(*posJoX), &(*posJoY), &(*perdu));
     *nbDeplacement = 0;
-    affichage_complet(plateau, tabDeplacement, nomNiveau, *nbDeplacement,
-                      *niveauZoom, errorPosJo);
+    // la partie recommence : les anciens coups ne sont plus à refaire
+    couper_historique(historique, 0);
+    affichage_complet(plateau, plateauBase, historique, nomNiveau,
+                      *nbDeplacement, *niveauZoom, errorPosJo);
     errorPosJo = FAUX;
   }
   if (touche == UNDO) {
-    annuler_deplacement(plateau, plateauBase, tabDeplacement, &(*posJoX),
+    annuler_deplacement(plateau, plateauBase, historique, &(*posJoX),
       &(*posJoY), &(*nbDeplacement));
+    *perdu = plateau_perdu(plateau, niveau);
   }
   if ((touche == ZOOM) && (*niveauZoom < MAX_ZOOM)) {
     *niveauZoom += 1;
@@ -286,7 +1058,316 @@ void jeu(char touche, t_plateau plateau, t_plateau plateauBase,
   if ((touche == DEZOOM) && (*niveauZoom > MIN_ZOOM)) {
     *niveauZoom -= 1;
   }
-  *gagner = gagne(plateau, plateauBase);
+  if (touche == INDICE) {
+    demander_indice(indice, plateau);
+  } else {
+    oublier_indice(indice);
+  }
+  *gagner = gagne(plateau);
+}
+
+/**
+ * @brief Fonction qui indique si un caractère de déplacement (hbgdHBGD) est
+ * une poussée.
+ * @param c char, caractère du tableau des déplacements
+ */
+bool deplacement_avec_caisse(char c) {
+  return (c == HAUT_AVEC_CAISSE) || (c == BAS_AVEC_CAISSE) ||
+         (c == GAUCHE_AVEC_CAISSE) || (c == DROITE_AVEC_CAISSE);
+}
+
+/**
+ * @brief Fonction qui vérifie après une poussée si la caisse poussée rend la
+ * partie perdue : case morte hors cible, ou caisse gelée hors cible (coin,
+ * mur, autres caisses gelées). Seule la caisse poussée est examinée et le gel
+ * est borné par LIMITE_GEL, le temps ne dépend pas de la taille de la partie.
+ * @param plateau t_plateau, plateau de jeu
+ * @param niveau t_niveau, analyse du niveau
+ * @param ligne int, ligne de la caisse
+ * @param colonne int, colonne de la caisse
+ * @return VRAI si la partie ne peut plus être gagnée
+ */
+bool caisse_perdue(t_plateau *plateau, const t_niveau *niveau, int ligne,
+    int colonne) {
+  int laCase = ligne * niveau->largeur + colonne;
+  if (laCase >= niveau->nbCases) {
+    return FAUX; // niveau trop grand pour être analysé
+  }
+  if (masque_contient(niveau->casesMortes, laCase)) {
+    return VRAI;
+  }
+  // le plateau du jeu a la même numérotation à plat que celui du solveur
+  return blocage_gel(plateau->cases, niveau, laCase);
+}
+
+/**
+ * @brief Fonction qui vérifie toutes les caisses du plateau, après une
+ * annulation ou au chargement d'une partie.
+ * @param plateau t_plateau, plateau de jeu
+ * @param niveau t_niveau, analyse du niveau
+ * @return VRAI si la partie ne peut plus être gagnée
+ */
+bool plateau_perdu(t_plateau *plateau, const t_niveau *niveau) {
+  bool perdu = FAUX;
+  int laCase;
+  // seulement les caisses de la liste, pas tout le plateau
+  for (int i = 0; (i < plateau->nbCaisses) && !perdu; i++) {
+    laCase = plateau->caisses[i];
+    perdu = caisse_perdue(plateau, niveau, laCase / plateau->largeur,
+                          laCase % plateau->largeur);
+  }
+  return perdu;
+}
+
+/**
+ * @brief Procédure qui démarre le thread des indices. Il attend les demandes
+ * et cherche la suite des poussées avec A* sans bloquer la lecture des
+ * touches.
+ * @param indice t_indice, en sortie
+ * @param niveau t_niveau, analyse du niveau en cours (lue par le thread)
+ */
+void init_indice(t_indice *indice, const t_niveau *niveau) {
+  indice->niveau = niveau;
+  indice->demande = FAUX;
+  indice->enCours = FAUX;
+  indice->arret = FAUX;
+  indice->fin = FAUX;
+  indice->nouveau = FAUX;
+  indice->etat = INDICE_AUCUN;
+  indice->cleDemande = 0;
+  indice->cleEnCours = 0;
+  indice->cleEchec = 0;
+  memset(indice->conseils, 0, sizeof(indice->conseils));
+  pthread_mutex_init(&indice->verrou, NULL);
+  pthread_cond_init(&indice->signal, NULL);
+  pthread_create(&indice->thread, NULL, chercher_indices, indice);
+}
+
+/**
+ * @brief Procédure qui arrête le thread des indices et libère ses verrous.
+ * @param indice t_indice
+ */
+void liberer_indice(t_indice *indice) {
+  pthread_mutex_lock(&indice->verrou);
+  indice->fin = VRAI;
+  __atomic_store_n(&indice->arret, VRAI, __ATOMIC_RELAXED);
+  pthread_cond_broadcast(&indice->signal);
+  pthread_mutex_unlock(&indice->verrou);
+  pthread_join(indice->thread, NULL);
+  pthread_mutex_destroy(&indice->verrou);
+  pthread_cond_destroy(&indice->signal);
+}
+
+/**
+ * @brief Procédure qui interrompt la recherche en cours et vide le cache des
+ * conseils, à appeler avant de changer de niveau (le thread lit le niveau).
+ * @param indice t_indice
+ */
+void vider_indice(t_indice *indice) {
+  pthread_mutex_lock(&indice->verrou);
+  indice->demande = FAUX;
+  __atomic_store_n(&indice->arret, VRAI, __ATOMIC_RELAXED);
+  while (indice->enCours) {
+    pthread_cond_wait(&indice->signal, &indice->verrou);
+  }
+  __atomic_store_n(&indice->arret, FAUX, __ATOMIC_RELAXED);
+  memset(indice->conseils, 0, sizeof(indice->conseils));
+  indice->cleEchec = 0;
+  indice->etat = INDICE_AUCUN;
+  indice->nouveau = FAUX;
+  pthread_mutex_unlock(&indice->verrou);
+}
+
+/**
+ * @brief Procédure qui demande un indice pour le plateau courant : réponse
+ * immédiate si la position est dans le cache des conseils, sinon la recherche
+ * est confiée au thread des indices.
+ * @param indice t_indice
+ * @param plateau t_plateau, plateau de jeu
+ */
+void demander_indice(t_indice *indice, t_plateau *plateau) {
+  t_position position;
+  t_masque atteint;
+  t_conseil *conseil;
+  uint64_t cle;
+  init_position(plateau, indice->niveau, &position);
+  if (position.joueur == AUCUNE_CASE) {
+    // niveau trop grand pour le solveur
+    pthread_mutex_lock(&indice->verrou);
+    indice->etat = INDICE_IMPOSSIBLE;
+    pthread_mutex_unlock(&indice->verrou);
+    return;
+  }
+  position.joueur = acces_joueur(&position, indice->niveau, atteint);
+  cle = cle_position(&position, indice->niveau);
+  conseil = &indice->conseils[cle & (TAILLE_CONSEILS - 1)];
+  pthread_mutex_lock(&indice->verrou);
+  indice->cleDemande = cle;
+  if (conseil->cle == cle) {
+    indice->etat = INDICE_TROUVE;
+    indice->conseil = *conseil;
+  } else if (cle == indice->cleEchec) {
+    indice->etat = INDICE_IMPOSSIBLE;
+  } else if (indice->enCours && (indice->cleEnCours == cle) &&
+             !indice->demande) {
+    indice->etat = INDICE_CALCUL; // déjà cherchée, on attend la réponse
+  } else {
+    indice->plateau = *plateau;
+    indice->etat = INDICE_CALCUL;
+    indice->demande = VRAI;
+    // la recherche en cours porte sur une position qui n'est plus jouée
+    __atomic_store_n(&indice->arret, indice->enCours, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&indice->signal);
+  }
+  pthread_mutex_unlock(&indice->verrou);
+}
+
+/**
+ * @brief Procédure qui efface l'indice affiché, le joueur a bougé. Le cache
+ * et la recherche en cours sont gardés.
+ * @param indice t_indice
+ */
+void oublier_indice(t_indice *indice) {
+  pthread_mutex_lock(&indice->verrou);
+  indice->etat = INDICE_AUCUN;
+  pthread_mutex_unlock(&indice->verrou);
+}
+
+/**
+ * @brief Fonction qui indique si le thread des indices a répondu depuis le
+ * dernier affichage.
+ * @param indice t_indice
+ * @return VRAI si l'affichage doit être refait
+ */
+bool indice_nouveau(t_indice *indice) {
+  bool nouveau;
+  pthread_mutex_lock(&indice->verrou);
+  nouveau = indice->nouveau;
+  indice->nouveau = FAUX;
+  pthread_mutex_unlock(&indice->verrou);
+  return nouveau;
+}
+
+/**
+ * @brief Procédure qui affiche l'indice demandé sous le plateau.
+ * @param indice t_indice
+ */
+void afficher_indice(t_indice *indice) {
+  const char *directions[NB_DIRECTIONS] = {"le haut", "le bas", "la gauche",
+                                           "la droite"};
+  // le bord de sentinelles décale les cases d'une ligne et d'une colonne :
+  // on retrouve les numéros du fichier .sok en partant de 1
+  int largeur = indice->niveau->largeur, ecart, d = 0;
+  pthread_mutex_lock(&indice->verrou);
+  if (indice->etat == INDICE_CALCUL) {
+    printf(ORANGE "\n indice : recherche en cours...\n" RESET);
+  } else if (indice->etat == INDICE_IMPOSSIBLE) {
+    printf(RED "\n indice : aucune solution trouvée depuis cette position\n"
+               RESET);
+  } else if (indice->etat == INDICE_TROUVE) {
+    ecart = indice->conseil.arrivee - indice->conseil.depart;
+    while ((d < NB_DIRECTIONS - 1) && (indice->niveau->decalage[d] != ecart)) {
+      d++;
+    }
+    printf(BRIGHT_GREEN "\n indice : pousser la caisse ligne %d colonne %d "
+                        "vers %s\n" RESET,
+           indice->conseil.depart / largeur, indice->conseil.depart % largeur,
+           directions[d]);
+  }
+  pthread_mutex_unlock(&indice->verrou);
+}
+
+/**
+ * @brief Fonction du thread des indices : attend une demande, résout la
+ * position avec A* et range dans le cache le conseil de chaque position de la
+ * solution. Suivre l'indice mène donc à une position déjà dans le cache.
+ * @param argument t_indice
+ * @return NULL
+ */
+void *chercher_indices(void *argument) {
+  t_indice *indice = argument;
+  t_plateau plateau;
+  t_solveur *solveur = malloc(sizeof(t_solveur));
+  t_position position;
+  short depart[TAILLE_DEPLACEMENT], arrivee[TAILLE_DEPLACEMENT];
+  int but, nbPoussees = 0;
+
+  pthread_mutex_lock(&indice->verrou);
+  while (!indice->fin) {
+    if (!indice->demande) {
+      pthread_cond_wait(&indice->signal, &indice->verrou);
+      continue;
+    }
+    indice->demande = FAUX;
+    indice->enCours = VRAI;
+    indice->cleEnCours = indice->cleDemande;
+    __atomic_store_n(&indice->arret, FAUX, __ATOMIC_RELAXED);
+    plateau = indice->plateau;
+    pthread_mutex_unlock(&indice->verrou);
+
+    but = AUCUNE_CASE;
+    init_position(&plateau, indice->niveau, &position);
+    if ((solveur != NULL) && (position.joueur != AUCUNE_CASE) &&
+        init_solveur(solveur, indice->niveau, position.nbCaisses,
+                     MEMOIRE_INDICE)) {
+      solveur->arret = &indice->arret;
+      but = recherche_astar(solveur, &position);
+      if (but != AUCUNE_CASE) {
+        nbPoussees = extraire_poussees(solveur, but, depart, arrivee);
+        init_position(&plateau, indice->niveau, &position);
+      }
+      liberer_solveur(solveur);
+    }
+
+    pthread_mutex_lock(&indice->verrou);
+    if (but != AUCUNE_CASE) {
+      noter_conseils(indice, &position, depart, arrivee, nbPoussees);
+    }
+    if ((indice->etat == INDICE_CALCUL) && !indice->demande) {
+      // la réponse porte sur la dernière position demandée
+      t_conseil *conseil =
+          &indice->conseils[indice->cleDemande & (TAILLE_CONSEILS - 1)];
+      if (conseil->cle == indice->cleDemande) {
+        indice->etat = INDICE_TROUVE;
+        indice->conseil = *conseil;
+      } else if (!indice->arret) {
+        indice->etat = INDICE_IMPOSSIBLE;
+        indice->cleEchec = indice->cleDemande;
+      }
+      indice->nouveau = VRAI;
+    }
+    indice->enCours = FAUX;
+    pthread_cond_broadcast(&indice->signal);
+  }
+  pthread_mutex_unlock(&indice->verrou);
+  free(solveur);
+  return NULL;
+}
+
+/**
+ * @brief Procédure qui rejoue une solution et range dans le cache la poussée
+ * à jouer depuis chacune de ses positions.
+ * @param indice t_indice, verrou pris
+ * @param position t_position, position de départ de la solution (modifiée)
+ * @param depart tableau des cases de départ des caisses
+ * @param arrivee tableau des cases d'arrivée des caisses
+ * @param nbPoussees int, nombre de poussées
+ */
+void noter_conseils(t_indice *indice, t_position *position,
+    const short depart[], const short arrivee[], int nbPoussees) {
+  const t_niveau *niveau = indice->niveau;
+  t_masque atteint;
+  t_conseil *conseil;
+  uint64_t cle;
+  for (int p = 0; p < nbPoussees; p++) {
+    position->joueur = acces_joueur(position, niveau, atteint);
+    cle = cle_position(position, niveau);
+    conseil = &indice->conseils[cle & (TAILLE_CONSEILS - 1)];
+    conseil->cle = cle;
+    conseil->depart = depart[p];
+    conseil->arrivee = arrivee[p];
+    pousser_caisse(position, niveau, depart[p], arrivee[p]);
+  }
 }
 
 /**
@@ -324,220 +1405,728 @@ int kbhit() {
 }
 
 /**
- * @brief Procédure pour le chargement du niveau, transforme un fichier texte en
- * tableau 2D.
+ * @brief Procédure pour le chargement du niveau (lire_niveau()), arrête le
+ * programme si le fichier ne peut pas être ouvert.
  * @param plateau De type t_plateau pour remplir celui-ci grâce au fichier, en
  * entrer et en sortie
- * @param fichier le nom du fichier
+ * @param fichier le nom du fichier, suivi ou non de ':' et du numéro
  */
-void charger_partie(t_plateau plateau, char fichier[]) {
-  FILE *f;
-  char finDeLigne;
-
-  f = fopen(fichier, "r");
-  if (f == NULL) {
+void charger_partie(t_plateau *plateau, char fichier[]) {
+  if (!lire_niveau(plateau, fichier)) {
     printf("ERREUR SUR FICHIER");
     exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Fonction qui lit un niveau, transforme un fichier texte (lignes de
+ * longueur quelconque) en plateau à plat entouré de murs. Le fichier peut
+ * être une collection : « collection.xsb:12 » charge le douzième niveau, seul
+ * ce niveau est lu (le fichier est projeté en mémoire et indexé jusqu'à lui).
+ * Sans numéro, c'est le premier niveau du fichier. Un niveau absent ou trop
+ * grand donne un plateau sans joueur.
+ * @param plateau t_plateau, en sortie
+ * @param fichier le nom du fichier, suivi ou non de ':' et du numéro
+ * @return FAUX si le fichier ne peut pas être ouvert (plateau non écrit)
+ */
+bool lire_niveau(t_plateau *plateau, const char fichier[]) {
+  t_collection collection;
+  char nom[TAILLE_NOM_DISQUE];
+  char lignes[TAILLE_MAX - 2][TAILLE_MAX - 2];
+  int longueurs[TAILLE_MAX - 2];
+  int nbLignes = 0, largeur = 0, longueur, numero;
+  bool tropGrand = FAUX;
+  const char *ligne, *fin, *finLigne;
+
+  numero = numero_niveau(fichier, nom, sizeof(nom));
+  if (!ouvrir_collection(nom, &collection)) {
+    return FAUX;
+  }
+  if (!indexer_collection(&collection, numero)) {
+    // plateau vide, sans joueur : refusé comme un niveau invalide
+    fprintf(stderr, "%s : pas de niveau %d\n", nom, numero);
   } else {
-    for (int ligne = 0; ligne < TAILLE; ligne++) {
-      for (int colonne = 0; colonne < TAILLE; colonne++) {
-        fread(&plateau[ligne][colonne], sizeof(char), 1, f);
+    ligne = collection.texte + collection.niveaux[numero - 1].debut;
+    fin = collection.texte + collection.niveaux[numero - 1].fin;
+    while (!tropGrand && (ligne < fin)) {
+      finLigne = memchr(ligne, '\n', fin - ligne);
+      if (finLigne == NULL) {
+        finLigne = fin; // dernière ligne du fichier, sans retour à la ligne
+      }
+      longueur = (int)(finLigne - ligne);
+      while ((longueur > 0) && ((ligne[longueur - 1] == VIDE) ||
+                                (ligne[longueur - 1] == '\r'))) {
+        longueur--;
       }
-      fread(&finDeLigne, sizeof(char), 1, f);
+      if ((longueur > TAILLE_MAX - 2) || (nbLignes >= TAILLE_MAX - 2)) {
+        tropGrand = VRAI;
+      } else {
+        memcpy(lignes[nbLignes], ligne, longueur);
+        longueurs[nbLignes++] = longueur;
+        largeur = (longueur > largeur) ? longueur : largeur;
+      }
+      ligne = finLigne + 1;
     }
-    fclose(f);
   }
+  fermer_collection(&collection);
+  if (tropGrand) {
+    // plateau sans joueur : refusé comme un niveau invalide
+    fprintf(stderr, "%s : niveau plus grand que %d x %d\n", fichier,
+            TAILLE_MAX - 2, TAILLE_MAX - 2);
+    nbLignes = 0;
+    largeur = 0;
+  }
+  // une rangée de murs tout autour : un déplacement ne sort jamais du plateau
+  plateau->hauteur = nbLignes + 2;
+  plateau->largeur = largeur + 2;
+  memset(plateau->cases, BORD, plateau->hauteur * plateau->largeur);
+  for (int ligne = 0; ligne < nbLignes; ligne++) {
+    char *rangee = &plateau->cases[(ligne + 1) * plateau->largeur + 1];
+    memset(rangee, VIDE, largeur);
+    memcpy(rangee, lignes[ligne], longueurs[ligne]);
+  }
+  return VRAI;
 }
 
 /**
- * @brief Procédure pour enregistrer la partie, transforme un tableau 2D en
- * fichier texte.
- * @param plateau De type t_plateau pour récupérer les emplacements des
- * caractères du niveau
- * @param fichier le nom du fichier
+ * @brief Fonction qui sépare le nom du fichier et le numéro du niveau :
+ * « collection.xsb:12 » donne « collection.xsb » et 12.
+ * @param fichier char*, nom tapé ou passé en option
+ * @param nom char*, nom du fichier seul, en sortie
+ * @param taille size_t, taille de nom
+ * @return le numéro du niveau (à partir de 1), 1 s'il n'y en a pas
  */
-void enregistrer_partie(t_plateau plateau, char fichier[]) {
-  FILE *f;
-  char finDeLigne = '\n';
+int numero_niveau(const char *fichier, char nom[], size_t taille) {
+  const char *separateur = strrchr(fichier, SEPARATEUR_NIVEAU);
+  int numero = 1;
+  snprintf(nom, taille, "%s", fichier);
+  if ((separateur != NULL) && (separateur[1] != '\0') &&
+      (strspn(separateur + 1, "0123456789") == strlen(separateur + 1)) &&
+      ((size_t)(separateur - fichier) < taille)) {
+    numero = atoi(separateur + 1);
+    nom[separateur - fichier] = '\0';
+  }
+  return numero;
+}
 
-  f = fopen(fichier, "w");
-  for (int ligne = 0; ligne < TAILLE; ligne++) {
-    for (int colonne = 0; colonne < TAILLE; colonne++) {
-      fwrite(&plateau[ligne][colonne], sizeof(char), 1, f);
+/**
+ * @brief Fonction qui projette un fichier de niveaux en mémoire (mmap) sans
+ * le lire : seules les pages parcourues par l'index sont chargées.
+ * @param fichier char*, nom du fichier
+ * @param collection t_collection, en sortie, index vide
+ * @return FAUX si le fichier ne peut pas être ouvert
+ */
+bool ouvrir_collection(const char *fichier, t_collection *collection) {
+  struct stat etat;
+  void *texte;
+  int fd = open(fichier, O_RDONLY);
+  bool ouvert = FAUX;
+
+  collection->texte = NULL;
+  collection->taille = 0;
+  collection->lu = 0;
+  collection->niveaux = NULL;
+  collection->nbNiveaux = 0;
+  collection->capacite = 0;
+  if (fd < 0) {
+    return FAUX;
+  }
+  if ((fstat(fd, &etat) == 0) && S_ISREG(etat.st_mode)) {
+    collection->taille = (size_t)etat.st_size;
+    ouvert = VRAI;
+    if (collection->taille > 0) {
+      // la projection reste valable après close()
+      texte = mmap(NULL, collection->taille, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (texte == MAP_FAILED) {
+        collection->taille = 0;
+        ouvert = FAUX;
+      } else {
+        collection->texte = texte;
+      }
     }
-    fwrite(&finDeLigne, sizeof(char), 1, f);
   }
-  fclose(f);
+  close(fd);
+  return ouvert;
 }
 
 /**
- * @brief Procédure pour l'enregistrement du tableau des déplacemement
- * @param t t_tabDeplacement
- * @param nb int , nb déplacements
- * @param fic string , nom du fichier
+ * @brief Procédure qui libère la projection du fichier et son index.
+ * @param collection t_collection
  */
-void enregistrer_deplacements(t_tabDeplacement t, int nb, char fic[]) {
-  FILE *f;
-
-  f = fopen(fic, "w");
-  fwrite(t, sizeof(char), nb, f);
-  fclose(f);
+void fermer_collection(t_collection *collection) {
+  if (collection->texte != NULL) {
+    munmap((void *)collection->texte, collection->taille);
+  }
+  free(collection->niveaux);
+  collection->texte = NULL;
+  collection->niveaux = NULL;
+  collection->nbNiveaux = 0;
+  collection->capacite = 0;
 }
 
 /**
- * @brief Focntion qui renvoie soit y si la touche y est préssé ou n si la
- * touche n est préssé
- * @return toucheS le caractère de la touche
- * */
-char get_touche_y_n() {
-  char toucheS = TOUCHE_NULL;
-  while ((toucheS != NO) && (toucheS != YES)) {
-    if (kbhit()) {
-      toucheS = getchar();
+ * @brief Fonction qui prolonge l'index des niveaux jusqu'au niveau demandé,
+ * sans analyser les niveaux : un niveau est une suite de rangées
+ * (ligne_plateau()), séparée des autres par des lignes vides, des titres
+ * (';') ou tout autre texte. La collection n'est pas gardée d'un chargement
+ * à l'autre : lire_niveau() ouvre le fichier et l'indexe depuis le début à
+ * chaque fois, jusqu'au niveau demandé seulement.
+ * S'arrête sur ERREUR MEMOIRE si l'index ne peut pas grandir.
+ * @param collection t_collection, en entrer et sortie
+ * @param numero int, numéro du niveau (à partir de 1)
+ * @return VRAI si le fichier a au moins numero niveaux
+ */
+bool indexer_collection(t_collection *collection, int numero) {
+  size_t debut, suite;
+  while ((collection->nbNiveaux < numero) &&
+         (collection->lu < collection->taille)) {
+    debut = collection->lu;
+    suite = ligne_suivante(collection, debut);
+    while ((collection->lu < collection->taille) &&
+           ligne_plateau(collection->texte + collection->lu,
+                         suite - collection->lu)) {
+      collection->lu = suite;
+      suite = ligne_suivante(collection, suite);
+    }
+    if (collection->lu == debut) {
+      collection->lu = suite; // titre ou ligne vide
+    } else {
+      if (collection->nbNiveaux == collection->capacite) {
+        int capacite = (collection->capacite == 0) ? 16
+                                                   : 2 * collection->capacite;
+        t_extrait *niveaux =
+            realloc(collection->niveaux, capacite * sizeof(t_extrait));
+        if (niveaux == NULL) {
+          printf("ERREUR MEMOIRE");
+          exit(EXIT_FAILURE);
+        }
+        collection->niveaux = niveaux;
+        collection->capacite = capacite;
+      }
+      collection->niveaux[collection->nbNiveaux].debut = debut;
+      collection->niveaux[collection->nbNiveaux].fin = collection->lu;
+      collection->nbNiveaux += 1;
     }
   }
-  return toucheS;
+  return (numero >= 1) && (collection->nbNiveaux >= numero);
 }
 
 /**
- * @brief Procédure pour le choix en fin de partie (sauvegarde ou non), utilise
- * la procédure.
- * @param plateau de type t_plateau pour que la procedure "enregistrer_partie"
- * puisse avoir le plateau.
+ * @brief Fonction qui donne le début de la ligne qui suit une position du
+ * fichier (après le prochain retour à la ligne), ou la fin du fichier.
+ * @param collection t_collection, fichier projeté
+ * @param position size_t, position dans la ligne courante
+ * @return la position de la ligne suivante
  */
-void sauvegarde_jeu(t_plateau plateau) {
-  char nomSauvegarde[40];
-  char toucheS = TOUCHE_NULL; // carac vide
-  affiche_abandon();
-  printf(BOLD YELLOW "\nVoulez vous sauvegarder ? (y,n) : " RESET);
-  toucheS = get_touche_y_n();
-  if (toucheS == YES) {
-    printf(BOLD YELLOW
-           "\nnom du fichier (30 caractères max) sans extention : " RESET);
-    scanf("%s", nomSauvegarde);
-    strcat(nomSauvegarde, FICHIER_SOK);
-    enregistrer_partie(plateau, nomSauvegarde);
-    printf(ORANGE "Partie sauvegardé dans le fichier : %s !\n" RESET,
-           nomSauvegarde);
-  }
+size_t ligne_suivante(const t_collection *collection, size_t position) {
+  const char *retour = memchr(collection->texte + position, '\n',
+                              collection->taille - position);
+  return (retour == NULL) ? collection->taille
+                          : (size_t)(retour - collection->texte) + 1;
 }
+
 /**
- * @brief Procédure pour le  déplacement du personnage et des caisses.
- * @param tabDeplacement type t_tabDeplacement, tableau des déplacements
- * @param nbDeplacement de type int
- *
+ * @brief Fonction qui indique si une ligne du fichier est une rangée de
+ * niveau : au moins un mur et seulement des caractères de plateau.
+ * @param ligne char*, début de la ligne (pas forcément terminée par '\0')
+ * @param longueur size_t, longueur, retour à la ligne compris
+ * @return VRAI pour une rangée, FAUX pour un titre ou une ligne vide
  */
-void sauvegarde_deplacements(t_tabDeplacement tabDeplacement,
-    int nbDeplacement) {
-  char nomSauvegarde[40];
-  char toucheS = TOUCHE_NULL; // carac vide
-  printf(BOLD YELLOW "\nVoulez vous sauvegarder la liste de vos déplacements ? "
-                     "(y,n) : " RESET);
-  toucheS = get_touche_y_n();
-  if (toucheS == YES) {
-    printf(BOLD YELLOW
-           "\nnom du fichier (30 caractères max) sans extention : " RESET);
-    scanf("%s", nomSauvegarde);
-    strcat(nomSauvegarde, FICHIER_DEP);
-    enregistrer_deplacements(tabDeplacement, nbDeplacement, nomSauvegarde);
-    printf(ORANGE "Déplacements sauvegardé dans le fichier : %s !\n" RESET,
-           nomSauvegarde);
+bool ligne_plateau(const char *ligne, size_t longueur) {
+  bool mur = FAUX, rangee = (longueur > 0) && (ligne[0] != COMMENTAIRE);
+  for (size_t i = 0; (i < longueur) && rangee; i++) {
+    if (ligne[i] == BORD) {
+      mur = VRAI;
+    } else if ((ligne[i] != '\n') && (ligne[i] != '\r')) {
+      rangee = (memchr(CARACTERES_PLATEAU, ligne[i],
+                       sizeof(CARACTERES_PLATEAU) - 1) != NULL);
+    }
   }
+  return rangee && mur;
 }
 
 /**
- * @brief Procédure pour le  déplacement du personnage et des caisses.
- * @param plateau de type t_plateau, tableau de jeu.
- * @param plateauBase de type t_plateau qui est une sauvegarde du plateau de
- * base.
- * @param touche de type caractère, est la valeur de la touche pressé,
- * par exemple 'z'.
- * @param posJoX de type entier, sur quel ligne du tableau est le joueur,
- * en entrer et sortie
- * @param posJoY de type entier; sur quel colonne du tableau est le joueur,
- * en entrer et sortie
- * @param nbDeplacement de type entier, compte le nombre de déplacements
- * effectué, en entrer et sortie
+ * @brief Procédure qui sépare un plateau tout juste chargé en ses deux
+ * couches : murs et cibles, qui ne changent plus, dans plateauBase, caisses
+ * et joueur dans plateau. Un déplacement n'écrit alors que dans plateau.
+ * @param plateau t_plateau, plateau lu dans le fichier, en entrer, couche
+ * mobile (CAISSE, JOUEUR ou VIDE) en sortie
+ * @param plateauBase t_plateau, couche fixe (BORD, CIBLE ou VIDE), en sortie
  */
-void deplacer(t_plateau plateau, t_plateau plateauBase,
-    t_tabDeplacement tabDeplacement, char touche, int *posJoX,
-    int *posJoY, int *nbDeplacement) {
-  int directionX = 0, directionY = 0;
-  int x = *posJoX, y = *posJoY;
-  int leDeplacement = PAS_DEPLACEMENT;
-  // +1 ou -1 sur les x ou y en fonctions de la direction
-  if (touche == HAUT) {
-    directionX = -1; // haut -> indice ligne -1
-  } else if (touche == BAS) {
-    directionX = 1; //  bas ->indice ligne +1
-  } else if (touche == GAUCHE) {
-    directionY = -1; // gauche ->indice colonne -1
-  } else if (touche == DROITE) {
-    directionY = 1; // droite ->indice colonne +1
-  }
-  char caseSuivante = plateau[x + directionX][y + directionY];
-  char caseApres;
-  // verification si sortie du tableau pour eviter les erreurs
-  if (((x + 2 * directionX >= 0) && (x + 2 * directionX < TAILLE)) &&
-      ((y + 2 * directionY >= 0) && (y + 2 * directionY < TAILLE))) {
-    caseApres = plateau[x + 2 * directionX][y + 2 * directionY];
-  } else {
-    return;
-  }
-  // deplacement :
-  if (caseSuivante == BORD) {
-    return;
-  }
-  if ((caseSuivante == CAISSE) || (caseSuivante == OBJECTIF)) {
-    if ((caseApres == VIDE) || (caseApres == CIBLE)) {
-      if (caseApres == CIBLE) {
-        plateau[x + 2 * directionX][y + 2 * directionY] = OBJECTIF;
-      } else {
-        plateau[x + 2 * directionX][y + 2 * directionY] = CAISSE;
-      }
-      // ici pour les maguscules
-      leDeplacement = AVEC_CAISSE;
+void separer_couches(t_plateau *plateau, t_plateau *plateauBase) {
+  int nbCases = plateau->hauteur * plateau->largeur;
+  char c;
+
+  plateauBase->hauteur = plateau->hauteur;
+  plateauBase->largeur = plateau->largeur;
+  for (int laCase = 0; laCase < nbCases; laCase++) {
+    c = plateau->cases[laCase];
+    if (c == BORD) {
+      plateauBase->cases[laCase] = BORD;
+    } else if ((c == CIBLE) || (c == OBJECTIF) || (c == JOUEUR_SUR_CIBLE)) {
+      plateauBase->cases[laCase] = CIBLE;
     } else {
-      return; // bloqué
+      plateauBase->cases[laCase] = VIDE;
+    }
+    if ((c == CAISSE) || (c == OBJECTIF)) {
+      plateau->cases[laCase] = CAISSE;
+    } else if ((c == JOUEUR) || (c == JOUEUR_SUR_CIBLE)) {
+      plateau->cases[laCase] = JOUEUR;
+    } else {
+      plateau->cases[laCase] = VIDE;
     }
   }
-  // remplacement du caractères ou etait le joueur
-  remplace_caractere(plateau, plateauBase, *posJoX, *posJoY);
-  // deplacement joueur
-  deplacer_joueur(plateau, plateauBase, x + directionX, y + directionY);
-  // si leDeplacement = et que on arrive ici alors leDeplacement = SANS_CAISSE
-  memoriser_deplacement(touche, tabDeplacement, leDeplacement, *nbDeplacement);
-  *posJoX += directionX; // actualisation des coordonnées
-  *posJoY += directionY;
-  // comptage des déplacements
-  if ((touche == HAUT) || (touche == BAS) || (touche == GAUCHE) ||
-      (touche == DROITE)) {
-    *nbDeplacement += 1;
-  }
+  plateau->ciblesLibres = compter_cibles_libres(plateau, plateauBase);
+  indexer_caisses(plateau);
 }
 
-void deplacer_joueur(t_plateau plateau, t_plateau plateauBase, int directionX,
-    int directionY) {
-  if (plateauBase[directionX][directionY] == CIBLE ||
-      plateauBase[directionX][directionY] == OBJECTIF) {
-    plateau[directionX][directionY] = JOUEUR_SUR_CIBLE;
-  } else {
-    plateau[directionX][directionY] = JOUEUR;
+/**
+ * @brief Procédure qui range les caisses de la couche mobile dans sa liste
+ * (caisses, nbCaisses) et note le numéro de chaque caisse sur sa case, une
+ * seule fois au chargement : bouger_caisse() les tient ensuite à jour.
+ * @param plateau t_plateau, couche mobile, en entrer et sortie
+ */
+void indexer_caisses(t_plateau *plateau) {
+  int nbCases = plateau->hauteur * plateau->largeur;
+  plateau->nbCaisses = 0;
+  for (int laCase = 0; laCase < nbCases; laCase++) {
+    if (plateau->cases[laCase] == CAISSE) {
+      plateau->numeroCaisse[laCase] = plateau->nbCaisses;
+      plateau->caisses[plateau->nbCaisses] = laCase;
+      plateau->nbCaisses += 1;
+    } else {
+      plateau->numeroCaisse[laCase] = AUCUNE_CASE;
+    }
   }
 }
 
 /**
- * @brief procedure qui enregistre les déplacements du joueur.
- * @param touche char, touche préssé par le joueur.
- * @param tabDeplacement t_tabDeplacement, tableau des déplacements.
- * @param leDeplacement int, permet de savoir si le déplacements c'est fait avec
- * une caisse ou non
- * @param nbDeplacement int, pour l'insertion des déplacements
+ * @brief Procédure qui déplace une caisse de la couche mobile : la case, la
+ * liste des caisses et le compte des cibles libres, en O(1). La case
+ * d'arrivée doit être libre.
+ * @param plateau t_plateau, couche mobile, en entrer et sortie
+ * @param plateauBase t_plateau, couche fixe, pour les cibles
+ * @param depart int, case de la caisse
+ * @param arrivee int, case où elle va
  */
-void memoriser_deplacement(char touche, t_tabDeplacement tabDeplacement,
-    int leDeplacement, int nbDeplacement) {
-  char caracDeplacement = TOUCHE_NULL;
-  if (leDeplacement == PAS_DEPLACEMENT) {
+void bouger_caisse(t_plateau *plateau, t_plateau *plateauBase, int depart,
+    int arrivee) {
+  int numero = plateau->numeroCaisse[depart];
+  plateau->cases[depart] = VIDE;
+  plateau->cases[arrivee] = CAISSE;
+  plateau->caisses[numero] = arrivee;
+  plateau->numeroCaisse[arrivee] = numero;
+  plateau->numeroCaisse[depart] = AUCUNE_CASE;
+  // la caisse quitte peut-être une cible et arrive peut-être sur une autre
+  plateau->ciblesLibres += (plateauBase->cases[depart] == CIBLE) -
+                           (plateauBase->cases[arrivee] == CIBLE);
+}
+
+/**
+ * @brief Fonction qui rassemble les deux couches d'une case en un seul
+ * caractère, celui du fichier .sok : caisse sur cible '*', joueur sur cible
+ * '+'...
+ * @param mobile char, case de la couche mobile (CAISSE, JOUEUR ou VIDE)
+ * @param fixe char, case de la couche fixe (BORD, CIBLE ou VIDE)
+ * @return le caractère de la case
+ */
+char caractere_case(char mobile, char fixe) {
+  char c = fixe;
+  if (mobile == CAISSE) {
+    c = (fixe == CIBLE) ? OBJECTIF : CAISSE;
+  } else if (mobile == JOUEUR) {
+    c = (fixe == CIBLE) ? JOUEUR_SUR_CIBLE : JOUEUR;
+  }
+  return c;
+}
+
+/**
+ * @brief Procédure pour enregistrer la partie, transforme le plateau (sans
+ * son bord de sentinelles) en fichier texte.
+ * @param plateau De type t_plateau, couche mobile (caisses et joueur)
+ * @param plateauBase De type t_plateau, couche fixe (murs et cibles)
+ * @param fichier le nom du fichier
+ */
+void enregistrer_partie(t_plateau *plateau, t_plateau *plateauBase,
+    char fichier[]) {
+  FILE *f;
+  char texte[TAILLE_MAX + 1];
+  int laCase;
+
+  f = fopen(fichier, "w");
+  for (int ligne = 1; ligne < plateau->hauteur - 1; ligne++) {
+    for (int colonne = 1; colonne < plateau->largeur - 1; colonne++) {
+      laCase = ligne * plateau->largeur + colonne;
+      texte[colonne - 1] = caractere_case(plateau->cases[laCase],
+                                          plateauBase->cases[laCase]);
+    }
+    texte[plateau->largeur - 2] = '\n';
+    fwrite(texte, sizeof(char), plateau->largeur - 1, f);
+  }
+  fclose(f);
+}
+
+/**
+ * @brief Procédure pour l'enregistrement du tableau des déplacemement, en
+ * texte (hbgdHBGD) ou sur 3 bits par coup si le nom finit par .dpk
+ * @param historique t_historique, déplacements de la partie
+ * @param nb int , nb déplacements
+ * @param fic string , nom du fichier
+ */
+void enregistrer_deplacements(t_historique *historique, int nb, char fic[]) {
+  FILE *f;
+
+  f = fopen(fic, "wb");
+  if (fichier_compact(fic)) {
+    ecrire_compact(historique, nb, f);
+  } else {
+    ecrire_historique(historique, nb, f);
+  }
+  fclose(f);
+}
+
+/**
+ * @brief Fonction qui indique si un nom de fichier a l'extension .dpk.
+ * @param fic chaîne, nom du fichier
+ */
+bool fichier_compact(const char *fic) {
+  size_t longueur = strlen(fic), extension = strlen(FICHIER_DEP_COMPACT);
+  return (longueur > extension) &&
+         (strcmp(fic + longueur - extension, FICHIER_DEP_COMPACT) == 0);
+}
+
+/**
+ * @brief Procédure qui écrit les premiers déplacements de l'historique dans
+ * un fichier ouvert, en texte (hbgdHBGD), un morceau à la fois.
+ * @param historique t_historique, déplacements
+ * @param nb int, nombre de déplacements à écrire
+ * @param f FILE, fichier ouvert en écriture
+ */
+void ecrire_historique(const t_historique *historique, int nb, FILE *f) {
+  char texte[TAILLE_MORCEAU];
+  int taille;
+  for (int m = 0; nb > 0; m++) {
+    taille = (nb < TAILLE_MORCEAU) ? nb : TAILLE_MORCEAU;
+    for (int i = 0; i < taille; i++) {
+      texte[i] = CARACTERES_COUPS[lire_code(historique->morceaux[m], i)];
+    }
+    fwrite(texte, sizeof(char), taille, f);
+    nb -= taille;
+  }
+}
+
+/**
+ * @brief Procédure qui écrit les premiers déplacements de l'historique au
+ * format .dpk : l'entête "DEP3", le nombre de coups sur 4 octets (poids
+ * faible d'abord) puis les coups sur 3 bits, tels qu'ils sont en mémoire.
+ * @param historique t_historique, déplacements
+ * @param nb int, nombre de déplacements à écrire
+ * @param f FILE, fichier ouvert en écriture
+ */
+void ecrire_compact(const t_historique *historique, int nb, FILE *f) {
+  uint8_t nombre[4], dernier;
+  int taille, octets, bits;
+  fwrite(ENTETE_COMPACT, sizeof(char), strlen(ENTETE_COMPACT), f);
+  for (int i = 0; i < 4; i++) {
+    nombre[i] = (uint8_t)(nb >> (8 * i));
+  }
+  fwrite(nombre, sizeof(uint8_t), 4, f);
+  // TAILLE_MORCEAU est un multiple de 8 : les morceaux se suivent sans trou
+  for (int m = 0; nb > 0; m++) {
+    taille = (nb < TAILLE_MORCEAU) ? nb : TAILLE_MORCEAU;
+    bits = taille * BITS_COUP;
+    octets = bits / 8;
+    fwrite(historique->morceaux[m], sizeof(uint8_t), octets, f);
+    if (bits % 8 != 0) {
+      // bits au-delà du dernier coup mis à zéro (restes de coups oubliés)
+      dernier = historique->morceaux[m][octets] & ((1 << (bits % 8)) - 1);
+      fwrite(&dernier, sizeof(uint8_t), 1, f);
+    }
+    nb -= taille;
+  }
+}
+
+/**
+ * @brief Fonction qui donne le code sur 3 bits d'un déplacement.
+ * @param coup char, déplacement hbgdHBGD
+ * @return la direction (0 à 3), plus NB_DIRECTIONS pour une poussée
+ */
+int code_coup(char coup) {
+  return direction_deplacement(coup) +
+         (deplacement_avec_caisse(coup) ? NB_DIRECTIONS : 0);
+}
+
+/**
+ * @brief Fonction qui lit le code d'un coup dans une suite de codes sur 3
+ * bits (le premier coup dans les bits de poids faible du premier octet).
+ * @param octets tableau des codes, un octet de plus que nécessaire
+ * @param indice int, numéro du coup
+ * @return le code, de 0 à 7
+ */
+int lire_code(const uint8_t octets[], int indice) {
+  int bit = indice * BITS_COUP;
+  int deux = octets[bit / 8] | (octets[bit / 8 + 1] << 8);
+  return (deux >> (bit % 8)) & ((1 << BITS_COUP) - 1);
+}
+
+/**
+ * @brief Procédure qui écrit le code d'un coup dans une suite de codes sur 3
+ * bits, sans toucher aux autres coups.
+ * @param octets tableau des codes, un octet de plus que nécessaire
+ * @param indice int, numéro du coup
+ * @param code int, de 0 à 7
+ */
+void ecrire_code(uint8_t octets[], int indice, int code) {
+  int bit = indice * BITS_COUP;
+  int deux = octets[bit / 8] | (octets[bit / 8 + 1] << 8);
+  deux &= ~(((1 << BITS_COUP) - 1) << (bit % 8));
+  deux |= code << (bit % 8);
+  octets[bit / 8] = (uint8_t)deux;
+  octets[bit / 8 + 1] = (uint8_t)(deux >> 8);
+}
+
+/**
+ * @brief Procédure qui prépare un historique vide, sans mémoire allouée.
+ * @param historique t_historique, en sortie
+ */
+void init_historique(t_historique *historique) {
+  historique->morceaux = NULL;
+  historique->nbMorceaux = 0;
+  historique->capacite = 0;
+  historique->nbCoups = 0;
+}
+
+/**
+ * @brief Procédure qui rend toute la mémoire de l'historique.
+ * @param historique t_historique, vide en sortie
+ */
+void liberer_historique(t_historique *historique) {
+  couper_historique(historique, 0);
+  free(historique->morceaux);
+  init_historique(historique);
+}
+
+/**
+ * @brief Procédure qui ne garde que les nb premiers coups de l'historique et
+ * rend les morceaux devenus inutiles (coups à refaire oubliés).
+ * @param historique t_historique, en entrer et sortie
+ * @param nb int, nombre de coups gardés
+ */
+void couper_historique(t_historique *historique, int nb) {
+  int garde = (nb + TAILLE_MORCEAU - 1) / TAILLE_MORCEAU;
+  while (historique->nbMorceaux > garde) {
+    historique->nbMorceaux -= 1;
+    free(historique->morceaux[historique->nbMorceaux]);
+  }
+  historique->nbCoups = nb;
+}
+
+/**
+ * @brief Procédure qui mémorise un coup. Si c'est le premier coup annulé qui
+ * est rejoué, les coups à refaire sont gardés ; sinon ils sont oubliés.
+ * Le coup est rangé sur 3 bits (code_coup()).
+ * Un morceau est ajouté quand le dernier est plein, le tableau des morceaux
+ * double de taille : ajout en O(1) amorti. S'arrête sur ERREUR MEMOIRE si
+ * l'allocation échoue.
+ * @param historique t_historique, en entrer et sortie
+ * @param indice int, numéro du coup (nombre de déplacements avant lui)
+ * @param coup char, déplacement hbgdHBGD
+ */
+void ecrire_coup(t_historique *historique, int indice, char coup) {
+  int code = code_coup(coup);
+  if ((indice < historique->nbCoups) &&
+      (lire_code(historique->morceaux[indice / TAILLE_MORCEAU],
+                 indice % TAILLE_MORCEAU) == code)) {
+    return;
+  }
+  couper_historique(historique, indice);
+  if (indice / TAILLE_MORCEAU >= historique->nbMorceaux) {
+    if (historique->nbMorceaux == historique->capacite) {
+      int capacite = (historique->capacite == 0) ? 4
+                                                 : 2 * historique->capacite;
+      uint8_t **morceaux =
+          realloc(historique->morceaux, capacite * sizeof(uint8_t *));
+      if (morceaux == NULL) {
+        printf("ERREUR MEMOIRE");
+        exit(EXIT_FAILURE);
+      }
+      historique->morceaux = morceaux;
+      historique->capacite = capacite;
+    }
+    historique->morceaux[historique->nbMorceaux] = calloc(OCTETS_MORCEAU, 1);
+    if (historique->morceaux[historique->nbMorceaux] == NULL) {
+      printf("ERREUR MEMOIRE");
+      exit(EXIT_FAILURE);
+    }
+    historique->nbMorceaux += 1;
+  }
+  ecrire_code(historique->morceaux[indice / TAILLE_MORCEAU],
+              indice % TAILLE_MORCEAU, code);
+  historique->nbCoups = indice + 1;
+}
+
+/**
+ * @brief Fonction qui donne un coup mémorisé.
+ * @param historique t_historique, déplacements
+ * @param indice int, numéro du coup, inférieur à nbCoups
+ * @return le déplacement hbgdHBGD
+ */
+char coup_historique(const t_historique *historique, int indice) {
+  const uint8_t *morceau = historique->morceaux[indice / TAILLE_MORCEAU];
+  return CARACTERES_COUPS[lire_code(morceau, indice % TAILLE_MORCEAU)];
+}
+
+/**
+ * @brief Fonction qui donne la touche à rejouer pour refaire le dernier coup
+ * annulé.
+ * @param historique t_historique, déplacements
+ * @param nbDeplacement int, nombre de déplacements joués
+ * @return la touche zqsd, TOUCHE_NULL s'il n'y a rien à refaire
+ */
+char touche_refaire(const t_historique *historique, int nbDeplacement) {
+  char touche = TOUCHE_NULL;
+  if (nbDeplacement < historique->nbCoups) {
+    touche = touche_direction(
+        direction_deplacement(coup_historique(historique, nbDeplacement)));
+  }
+  return touche;
+}
+
+/**
+ * @brief Focntion qui renvoie soit y si la touche y est préssé ou n si la
+ * touche n est préssé
+ * @return toucheS le caractère de la touche
+ * */
+char get_touche_y_n() {
+  char toucheS = TOUCHE_NULL;
+  while ((toucheS != NO) && (toucheS != YES)) {
+    if (kbhit()) {
+      toucheS = getchar();
+    }
+  }
+  return toucheS;
+}
+
+/**
+ * @brief Procédure pour le choix en fin de partie (sauvegarde ou non), utilise
+ * la procédure.
+ * @param plateau de type t_plateau pour que la procedure "enregistrer_partie"
+ * puisse avoir le plateau.
+ * @param plateauBase de type t_plateau, murs et cibles du plateau
+ */
+void sauvegarde_jeu(t_plateau *plateau, t_plateau *plateauBase) {
+  char nomSauvegarde[40];
+  char toucheS = TOUCHE_NULL; // carac vide
+  affiche_abandon();
+  printf(BOLD YELLOW "\nVoulez vous sauvegarder ? (y,n) : " RESET);
+  toucheS = get_touche_y_n();
+  if (toucheS == YES) {
+    printf(BOLD YELLOW
+           "\nnom du fichier (30 caractères max) sans extention : " RESET);
+    scanf("%s", nomSauvegarde);
+    strcat(nomSauvegarde, FICHIER_SOK);
+    enregistrer_partie(plateau, plateauBase, nomSauvegarde);
+    printf(ORANGE "Partie sauvegardé dans le fichier : %s !\n" RESET,
+           nomSauvegarde);
+  }
+}
+/**
+ * @brief Procédure pour le  déplacement du personnage et des caisses.
+ * @param historique type t_historique, déplacements de la partie
+ * @param nbDeplacement de type int
+ *
+ */
+void sauvegarde_deplacements(t_historique *historique, int nbDeplacement) {
+  char nomSauvegarde[40];
+  char toucheS = TOUCHE_NULL; // carac vide
+  printf(BOLD YELLOW "\nVoulez vous sauvegarder la liste de vos déplacements ? "
+                     "(y,n) : " RESET);
+  toucheS = get_touche_y_n();
+  if (toucheS == YES) {
+    printf(BOLD YELLOW
+           "\nnom du fichier (30 caractères max) sans extention, ou avec "
+           "l'extension .dpk pour le format compact : " RESET);
+    scanf("%s", nomSauvegarde);
+    if (!fichier_compact(nomSauvegarde)) {
+      strcat(nomSauvegarde, FICHIER_DEP);
+    }
+    enregistrer_deplacements(historique, nbDeplacement, nomSauvegarde);
+    printf(ORANGE "Déplacements sauvegardé dans le fichier : %s !\n" RESET,
+           nomSauvegarde);
+  }
+}
+
+/**
+ * @brief Procédure pour le  déplacement du personnage et des caisses.
+ * @param plateau de type t_plateau, caisses et joueur, modifié.
+ * @param plateauBase de type t_plateau, murs et cibles, seulement lu.
+ * @param touche de type caractère, est la valeur de la touche pressé,
+ * par exemple 'z'.
+ * @param posJoX de type entier, sur quel ligne du tableau est le joueur,
+ * en entrer et sortie
+ * @param posJoY de type entier; sur quel colonne du tableau est le joueur,
+ * en entrer et sortie
+ * @param nbDeplacement de type entier, compte le nombre de déplacements
+ * effectué, en entrer et sortie
+ */
+void deplacer(t_plateau *plateau, t_plateau *plateauBase,
+    t_historique *historique, char touche, int *posJoX,
+    int *posJoY, int *nbDeplacement) {
+  int directionX = 0, directionY = 0;
+  int x = *posJoX, y = *posJoY;
+  int leDeplacement = PAS_DEPLACEMENT;
+  // +1 ou -1 sur les x ou y en fonctions de la direction
+  if (touche == HAUT) {
+    directionX = -1; // haut -> indice ligne -1
+  } else if (touche == BAS) {
+    directionX = 1; //  bas ->indice ligne +1
+  } else if (touche == GAUCHE) {
+    directionY = -1; // gauche ->indice colonne -1
+  } else if (touche == DROITE) {
+    directionY = 1; // droite ->indice colonne +1
+  } else {
+    return; // pas une touche de déplacement, rien à mémoriser
+  }
+  // case du joueur et écart d'une case dans la direction, à plat
+  int ici = x * plateau->largeur + y;
+  int pas = directionX * plateau->largeur + directionY;
+  // pas de vérification de sortie du tableau : le joueur et les caisses ne
+  // sont jamais sur le bord de murs, la case après reste dans le plateau
+  if (plateauBase->cases[ici + pas] == BORD) {
+    return;
+  }
+  if (plateau->cases[ici + pas] == CAISSE) {
+    if ((plateauBase->cases[ici + 2 * pas] == BORD) ||
+        (plateau->cases[ici + 2 * pas] == CAISSE)) {
+      return; // bloqué
+    }
+    bouger_caisse(plateau, plateauBase, ici + pas, ici + 2 * pas);
+    // ici pour les maguscules
+    leDeplacement = AVEC_CAISSE;
+  }
+  // les cibles restent dans plateauBase : rien à restaurer derrière le joueur
+  plateau->cases[ici] = VIDE;
+  plateau->cases[ici + pas] = JOUEUR;
+  // si leDeplacement = et que on arrive ici alors leDeplacement = SANS_CAISSE
+  memoriser_deplacement(touche, historique, leDeplacement, *nbDeplacement);
+  *posJoX += directionX; // actualisation des coordonnées
+  *posJoY += directionY;
+  // comptage des déplacements
+  *nbDeplacement += 1;
+}
+
+/**
+ * @brief procedure qui enregistre les déplacements du joueur.
+ * @param touche char, touche préssé par le joueur.
+ * @param historique t_historique, déplacements de la partie.
+ * @param leDeplacement int, permet de savoir si le déplacements c'est fait avec
+ * une caisse ou non
+ * @param nbDeplacement int, pour l'insertion des déplacements
+ */
+void memoriser_deplacement(char touche, t_historique *historique,
+    int leDeplacement, int nbDeplacement) {
+  char caracDeplacement = TOUCHE_NULL;
+  if (leDeplacement == PAS_DEPLACEMENT) {
     leDeplacement = SANS_CAISSE;
   }
 
@@ -554,30 +2143,31 @@ void memoriser_deplacement(char touche, t_tabDeplacement tabDeplacement,
     caracDeplacement = toupper(caracDeplacement);
     // changement des minuscules en majuscules (tables ascii)
   }
-  if (nbDeplacement < TAILLE_DEPLACEMENT) {
-    tabDeplacement[nbDeplacement] = caracDeplacement;
-  } else {
-    printf(RED "erreur trop de déplacement ! " RESET);
-  }
+  ecrire_coup(historique, nbDeplacement, caracDeplacement);
 }
 
 /**
  * @brief Procédure qui permet d'annuler un déplacement
- * @param plateau de type t_plateau, tableau de jeu.
- * @param plateauBase de type t_plateau, tableau de sauvegarde des
- * déplacements
+ * @param plateau de type t_plateau, caisses et joueur, les cibles n'y sont
+ * pas : rien à restaurer.
+ * @param plateauBase de type t_plateau, murs et cibles, pour le compte des
+ * cibles libres
+ * @param historique de type t_historique, déplacements de la partie
  * @param posJoX de type entier, sur quel ligne du tableau est le joueur,
  * en entrer et sortie
  * @param posJoY de type entier; sur quel colonne du tableau est le joueur,
  * en entrer et sortie
  * @param nbDeplacement int, nombre de déplacements du joueur
  */
-void annuler_deplacement(t_plateau plateau, t_plateau plateauBase,
-    t_tabDeplacement tabDeplacement, int *posJoX,
-    int *posJoY, int *nbDeplacement) {
-  char dep = tabDeplacement[*nbDeplacement - 1];
+void annuler_deplacement(t_plateau *plateau, t_plateau *plateauBase,
+    t_historique *historique, int *posJoX, int *posJoY,
+    int *nbDeplacement) {
+  char dep;
   int dx = 0, dy = 0;
+  int ici, pas;
   if (*nbDeplacement > 0) {
+    // le coup reste dans l'historique : c'est le prochain à refaire
+    dep = coup_historique(historique, *nbDeplacement - 1);
     if (dep == HAUT_SANS_CAISSE || dep == HAUT_AVEC_CAISSE)
       dx = 1;
     else if (dep == BAS_SANS_CAISSE || dep == BAS_AVEC_CAISSE)
@@ -588,19 +2178,17 @@ void annuler_deplacement(t_plateau plateau, t_plateau plateauBase,
       dy = -1;
     int avecCaisse = (dep == HAUT_AVEC_CAISSE || dep == BAS_AVEC_CAISSE ||
                       dep == GAUCHE_AVEC_CAISSE || dep == DROITE_AVEC_CAISSE);
-    remplace_caractere(plateau, plateauBase, *posJoX, *posJoY);
+    ici = *posJoX * plateau->largeur + *posJoY;
+    pas = dx * plateau->largeur + dy; // vers la case d'où vient le joueur
     if (avecCaisse) {
-      if ((plateauBase[*posJoX][*posJoY] == CIBLE) ||
-          (plateauBase[*posJoX][*posJoY] == OBJECTIF)) {
-        plateau[*posJoX][*posJoY] = OBJECTIF;
-      } else {
-        plateau[*posJoX][*posJoY] = CAISSE;
-      }
-      remplace_caractere(plateau, plateauBase, *posJoX - dx, *posJoY - dy);
+      // le joueur quitte la case ici, la caisse y revient
+      bouger_caisse(plateau, plateauBase, ici - pas, ici);
+    } else {
+      plateau->cases[ici] = VIDE;
     }
+    plateau->cases[ici + pas] = JOUEUR;
     *posJoX += dx;
     *posJoY += dy;
-    deplacer_joueur(plateau, plateauBase, *posJoX, *posJoY);
     (*nbDeplacement) -= 1;
   }
 }
@@ -613,83 +2201,44 @@ void annuler_deplacement(t_plateau plateau, t_plateau plateauBase,
  * @param posJoY de type entier; sur quel colonne du tableau est le joueur,
  * en entrer et sortie
  */
-void recherche_pos_jo(t_plateau plateau, int *posJoX, int *posJoY) {
-  for (int longueur = 0; longueur < TAILLE; longueur++) {
-    for (int largeur = 0; largeur < TAILLE; largeur++) {
-      if ((plateau[longueur][largeur] == JOUEUR) ||
-          (plateau[longueur][largeur] == JOUEUR_SUR_CIBLE)) {
-        *posJoX = longueur;
-        *posJoY = largeur;
-        // return;
-      }
+void recherche_pos_jo(t_plateau *plateau, int *posJoX, int *posJoY) {
+  *posJoX = -1;
+  *posJoY = -1;
+  for (int laCase = 0; laCase < plateau->hauteur * plateau->largeur;
+       laCase++) {
+    if (plateau->cases[laCase] == JOUEUR) {
+      *posJoX = laCase / plateau->largeur;
+      *posJoY = laCase % plateau->largeur;
+      // return;
     }
   }
-  if ((*posJoX == 0) || (*posJoY == 0)) {
-    *posJoX = -1;
-    *posJoY = -1;
-  }
 }
 
 /**
- * @brief Procédure pour remplacelement de caractère "après" déplacement du
- * joueur
- * @param plateau de type t_plateau, tableau de jeu.
- * @param plateauBase de type t_plateau qui est une sauvegarde du plateau de
- * base.
- * @param posJoX de type entier, sur quel ligne du tableau est le joueur,
- * en entrer et sortie
- * @param posJoY de type entier; sur quel colonne du tableau est le joueur,
- * en entrer et sortie
+ * @brief Fonction qui retourne vrai ou faux en fonction de si le joueus à
+ * gagner ou non, sans parcourir le plateau (compte des cibles libres).
+ * @param plateau de type t_plateau, caisses et joueur.
  */
-void remplace_caractere(t_plateau plateau, t_plateau plateauBase, int posX,
-    int posY) {
-  // remplace le caractère à cette position par un point si il y a un point à
-  // la base
-
-  if (plateauBase[posX][posY] == CIBLE) {
-    plateau[posX][posY] = CIBLE;
-  } else if (plateauBase[posX][posY] == OBJECTIF) {
-    // remplace '*' par un point
-    plateau[posX][posY] = CIBLE;
-  } else if (plateauBase[posX][posY] == JOUEUR_SUR_CIBLE) {
-    // remplacement de '+' par '.' lors du déplacement
-    plateau[posX][posY] = CIBLE;
-  } else {
-    // remplace le joueurs par un espace apres déplacement
-    plateau[posX][posY] = VIDE;
-  }
-}
+bool gagne(t_plateau *plateau) { return plateau->ciblesLibres == 0; }
 
 /**
- * @brief Fonction qui retourne vrai ou faux en fonction de si le joueus à
- * gagner ou non
- * @param plateau de type t_plateau, tableau de jeu.
- * @param plateauBase de type t_plateau qui est une sauvegarde du plateau de
- * base.
- */
-bool gagne(t_plateau plateau, t_plateau plateauBase) {
-  int nbCible = 0;
-  int nbObjectifs = 0;
-  bool gagner;
-  for (int longueur = 0; longueur < TAILLE; longueur++) {
-    for (int largeur = 0; largeur < TAILLE; largeur++) {
-      if ((plateauBase[longueur][largeur] == CIBLE) ||
-          (plateauBase[longueur][largeur] == OBJECTIF) ||
-          (plateauBase[longueur][largeur] == JOUEUR_SUR_CIBLE)) {
-        nbCible += 1;
-        if (plateau[longueur][largeur] == OBJECTIF) {
-          // dans le tableau c'est des * pas des $
-          nbObjectifs += 1;
-        }
-      }
+ * @brief Fonction qui compte les cibles sans caisse en parcourant tout le
+ * plateau, une seule fois au chargement : deplacer() et
+ * annuler_deplacement() tiennent ensuite le compte à jour.
+ * @param plateau de type t_plateau, caisses et joueur.
+ * @param plateauBase de type t_plateau, murs et cibles.
+ * @return le nombre de cibles sans caisse
+ */
+int compter_cibles_libres(t_plateau *plateau, t_plateau *plateauBase) {
+  int nbLibres = 0;
+  for (int laCase = 0; laCase < plateau->hauteur * plateau->largeur;
+       laCase++) {
+    if ((plateauBase->cases[laCase] == CIBLE) &&
+        (plateau->cases[laCase] != CAISSE)) {
+      nbLibres += 1;
     }
   }
-  if (nbObjectifs == nbCible) {
-    gagner = VRAI;
-  } else {
-    gagner = FAUX;
-  }
-  return gagner;
+  return nbLibres;
 }
 
 // AFFICHAGE
@@ -716,7 +2265,9 @@ void afficher_entete(int nbDeplacement, char nomNiveau[]) {
   printf("   - : dezoom       \n" RESET);
   printf("\n");
   printf(YELLOW "   u : annuler le dernier déplacement\n" RESET);
+  printf(YELLOW "   y : refaire le déplacement annulé\n" RESET);
   printf(YELLOW "   r : recommencer la partie\n" RESET);
+  printf(YELLOW "   i : indice, prochaine poussée\n" RESET);
   printf(RED "   x : quitter le jeu\n" RESET);
   // affichage du nombre déplacements (changement de l'alignement)
   printf(BLUE "╔══════════════════════════════════════════╗\n" RESET);
@@ -739,15 +2290,18 @@ void afficher_entete(int nbDeplacement, char nomNiveau[]) {
 /**
  * @brief Procédure qui affiche le plateau de jeu,
  * remplace certains caratère, par d'autre à l'affichage : ex '+' -> '@'.
- * @param plateau de type t_plateau, tableau de jeu.
+ * @param plateau de type t_plateau, caisses et joueur.
+ * @param plateauBase de type t_plateau, murs et cibles.
  * @param niveauZoom int, niveau du zoom
  */
-void affiche_plateau(t_plateau plateau, int niveauZoom) {
+void affiche_plateau(t_plateau *plateau, t_plateau *plateauBase,
+    int niveauZoom) {
   int longueur;
   int zooml;
-  for (longueur = 0; longueur < TAILLE; longueur++) {
+  // le bord de sentinelles n'est pas affiché
+  for (longueur = 1; longueur < plateau->hauteur - 1; longueur++) {
     for (zooml = 0; zooml < niveauZoom; zooml++) {
-      affiche_plateau_largeur(plateau, niveauZoom, longueur);
+      affiche_plateau_largeur(plateau, plateauBase, niveauZoom, longueur);
       printf("\n");
     }
   }
@@ -756,27 +2310,34 @@ void affiche_plateau(t_plateau plateau, int niveauZoom) {
 /**
  * @brief Procédure qui affiche le plateau de jeu,
  * remplace certains caratère par d'autre à l'affichage : ex '+' -> '@'.
- * @param plateau de type t_plateau, tableau de jeu.
+ * @param plateau de type t_plateau, caisses et joueur.
+ * @param plateauBase de type t_plateau, murs et cibles.
  * @param niveauZoom int, niveau du zoom
  */
-void affiche_plateau_largeur(t_plateau plateau, int niveauZoom, int longueur) {
+void affiche_plateau_largeur(t_plateau *plateau, t_plateau *plateauBase,
+    int niveauZoom, int longueur) {
   int largeur;
   int zoomc;
-  for (largeur = 0; largeur < TAILLE; largeur++) {
+  int laCase;
+  char c;
+  for (largeur = 1; largeur < plateau->largeur - 1; largeur++) {
+    // le caractère n'est reconstitué qu'ici, à l'affichage
+    laCase = longueur * plateau->largeur + largeur;
+    c = caractere_case(plateau->cases[laCase], plateauBase->cases[laCase]);
     for (zoomc = 0; zoomc < niveauZoom; zoomc++) {
-      if (plateau[longueur][largeur] == JOUEUR) {
+      if (c == JOUEUR) {
         printf(RED "%c" RESET, JOUEUR);
-      } else if (plateau[longueur][largeur] == OBJECTIF) {
+      } else if (c == OBJECTIF) {
         // affiche '$' mais dans le tableau c'est '*'
         printf(CYAN "%c" RESET, CAISSE);
-      } else if (plateau[longueur][largeur] == JOUEUR_SUR_CIBLE) {
+      } else if (c == JOUEUR_SUR_CIBLE) {
         printf(BRIGHT_MAGENTA "%c" RESET, JOUEUR);
-      } else if (plateau[longueur][largeur] == CAISSE) {
+      } else if (c == CAISSE) {
         printf(GREEN "%c" RESET, CAISSE);
-      } else if (plateau[longueur][largeur] == BORD) {
+      } else if (c == BORD) {
         printf(BG_WHITE "%c" RESET, BORD);
       } else {
-        printf("%c", plateau[longueur][largeur]);
+        printf("%c", c);
       }
     }
   }
@@ -784,18 +2345,19 @@ void affiche_plateau_largeur(t_plateau plateau, int niveauZoom, int longueur) {
 
 /**
  * @brief Procédure qui regroupe l'appet de affiche_entete et affiche_plateau.
- * @param plateau de type t_plateau, tableau de jeu.
+ * @param plateau de type t_plateau, caisses et joueur.
+ * @param plateauBase de type t_plateau, murs et cibles.
  * @param nomNiveau chaine de caratères, nom du niveau en cours.
  * @param nbDeplacement entier, nombre de déplacement du joueur.
  */
-void affichage_complet(t_plateau plateau, t_tabDeplacement tabDeplacement,
-    char nomNiveau[], int nbDeplacement, int niveauZoom,
-    bool errorPosJo) {
+void affichage_complet(t_plateau *plateau, t_plateau *plateauBase,
+    t_historique *historique, char nomNiveau[], int nbDeplacement,
+    int niveauZoom, bool errorPosJo) {
   system("clear");
 
   afficher_entete(nbDeplacement, nomNiveau);
-  affiche_plateau(plateau, niveauZoom);
-  // affiche_tab_dep(tabDeplacement, nbDeplacement);
+  affiche_plateau(plateau, plateauBase, niveauZoom);
+  // affiche_tab_dep(historique, nbDeplacement);
 }
 
 /**
@@ -863,11 +2425,14 @@ void affiche_niveau() {
   // la couleur comme je le voulais
   char cmd[256];
   snprintf(cmd, sizeof(cmd),
-           "bash -c 'printf \"%s\"; ls --color=never *.sok; printf \"%s\"'",
+           "bash -c 'printf \"%s\"; ls --color=never *.sok *.xsb 2>/dev/null;"
+           " printf \"%s\"'",
            BRIGHT_MAGENTA,
            RESET); // sizeof permet à snprintf() de ne jamais dépasser le
                    // tableau et d’éviter un overflow.
   system(cmd);
+  printf(CYAN "(collection : fichier.xsb:numero, par exemple jeux.xsb:12)\n"
+         RESET);
   printf(RED "\n('exit' pour quitter)\n" RESET);
   printf(YELLOW "Entrer un niveau : " RESET);
 }
@@ -875,19 +2440,4247 @@ void affiche_niveau() {
 /**
  * @brief Procédure qui affiche le tableau de déplacement.
  */
-void affiche_tab_dep(t_tabDeplacement tabDeplacement, int nbDeplacement) {
+void affiche_tab_dep(t_historique *historique, int nbDeplacement) {
   for (int i = 0; i < nbDeplacement; i++) {
-    printf("\033[38;5;250m %c " RESET, tabDeplacement[i]);
+    printf("\033[38;5;250m %c " RESET, coup_historique(historique, i));
   }
   printf("\n");
 }
 /**
- * @brief Procédure qui affiche un message d'erreur quand on dépasse le nb de
- * déplacement max
+ * @brief Procédure qui signale sous le plateau une partie perdue.
  */
-void affiche_erreur() {
-  system("clear");
-  printf(RED "nombre de déplacement trop grand : fatal error \n" RESET);
+void affiche_blocage() {
+  printf(RED BOLD "\n Partie perdue : une caisse ne peut plus atteindre de "
+                  "cible\n" RESET);
+  printf(YELLOW " u : annuler   r : recommencer\n" RESET);
+}
+
+// SOLVEUR
+
+/**
+ * @brief Fonction qui lit les options du mode sans affichage.
+ * @param argc nombre d'arguments
+ * @param argv arguments du programme
+ * @param options t_options, en sortie
+ * @return FAUX si une option est inconnue ou incomplète
+ */
+bool lire_options(int argc, char *argv[], t_options *options) {
+  // --optimise niveau.sok solution.dep : un fichier de plus avant les options,
+  // --bench : aucun fichier
+  bool banc = (strcmp(argv[1], OPTION_BANC) == 0);
+  bool dossier = (strcmp(argv[1], OPTION_RESOLUTION_DOSSIER) == 0);
+  int premier = (strcmp(argv[1], OPTION_OPTIMISATION) == 0) ? 4
+                : banc                                      ? 2
+                                                            : 3;
+  bool correct = (argc >= premier);
+  options->fichier = ((argc >= 3) && !banc) ? argv[2] : NULL;
+  options->deplacements = ((premier == 4) && (argc >= 4)) ? argv[3] : NULL;
+  options->fenetre = FENETRE_DEFAUT;
+  // --solve et --optimise sans limite de temps sauf avec --temps
+  options->tempsMax = banc ? TEMPS_BANC : dossier ? TEMPS_DEFAUT : 0;
+  options->memoireMo = banc ? MEMOIRE_BANC : MEMOIRE_DEFAUT;
+  options->base = NULL;
+  options->compact = NULL;
+  options->algorithme = ALGO_LARGEUR;
+  // un thread par processeur pour --solve-all, un seul sinon
+  options->nbThreads = dossier ? (int)sysconf(_SC_NPROCESSORS_ONLN) : 1;
+  options->nbThreads = (options->nbThreads > 0) ? options->nbThreads : 1;
+  options->dossier = NULL;
+  options->cacheMo = 0;
+  options->macros = FAUX;
+  for (int i = premier; (i < argc) && correct; i++) {
+    if ((strcmp(argv[i], OPTION_MEMOIRE) == 0) && (i + 1 < argc)) {
+      options->memoireMo = atol(argv[++i]);
+      correct = (options->memoireMo > 0);
+    } else if (strcmp(argv[i], OPTION_ASTAR) == 0) {
+      options->algorithme = ALGO_ASTAR;
+    } else if (strcmp(argv[i], OPTION_BIDIRECTIONNEL) == 0) {
+      options->algorithme = ALGO_BIDIRECTIONNEL;
+    } else if ((strcmp(argv[i], OPTION_DISQUE) == 0) && (i + 1 < argc)) {
+      options->algorithme = ALGO_DISQUE;
+      options->dossier = argv[++i];
+    } else if (strcmp(argv[i], OPTION_IDA) == 0) {
+      options->algorithme = ALGO_IDA;
+    } else if ((strcmp(argv[i], OPTION_CACHE) == 0) && (i + 1 < argc)) {
+      options->cacheMo = atol(argv[++i]);
+      correct = (options->cacheMo >= 0);
+    } else if ((strcmp(argv[i], OPTION_TEMPS) == 0) && (i + 1 < argc)) {
+      options->tempsMax = atol(argv[++i]);
+      correct = (options->tempsMax >= 0);
+    } else if ((strcmp(argv[i], OPTION_FENETRE) == 0) && (i + 1 < argc)) {
+      options->fenetre = atoi(argv[++i]);
+      correct = (options->fenetre > 0) && (options->fenetre <= MAX_FENETRE);
+    } else if (strcmp(argv[i], OPTION_MACROS) == 0) {
+      options->macros = VRAI;
+    } else if ((strcmp(argv[i], OPTION_BASE) == 0) && (i + 1 < argc)) {
+      options->base = argv[++i];
+    } else if ((strcmp(argv[i], OPTION_COMPACT) == 0) && (i + 1 < argc)) {
+      options->compact = argv[++i];
+    } else if ((strcmp(argv[i], OPTION_THREADS) == 0) && (i + 1 < argc)) {
+      options->nbThreads = atoi(argv[++i]);
+      correct = (options->nbThreads > 0);
+    } else {
+      correct = FAUX;
+    }
+  }
+  return correct;
+}
+
+/**
+ * @brief Fonction qui résout un niveau sans affichage et écrit la solution sur
+ * la sortie standard avec les mêmes caractères que le fichier .dep
+ * (hbgdHBGD). La recherche se fait en largeur sur les poussées, avec A* ou
+ * dans les deux sens à la fois, dans tous les cas la solution a le nombre
+ * minimal de poussées.
+ * @param options t_options, fichier .sok, mémoire autorisée et algorithme
+ * @return EXIT_SUCCESS si une solution est trouvée, EXIT_FAILURE sinon
+ */
+int resoudre_fichier(const t_options *options) {
+  char *fichier = options->fichier;
+  t_plateau plateau, plateauBase;
+  t_solveur solveur, arriere;
+  t_position position;
+  t_rencontre rencontre;
+  short depart[TAILLE_DEPLACEMENT], arrivee[TAILLE_DEPLACEMENT];
+  int nbPoussees, but;
+  int resultat = EXIT_FAILURE;
+  bool bidirectionnel = (options->algorithme == ALGO_BIDIRECTIONNEL);
+  bool horsDelai = FAUX;
+  long memoireMo = options->memoireMo;
+  long echeance = (options->tempsMax > 0)
+                      ? maintenant_ms() + options->tempsMax * 1000
+                      : 0;
+
+  charger_partie(&plateau, fichier);
+  separer_couches(&plateau, &plateauBase);
+  if (!analyser_niveau(&plateau, &plateauBase, &solveur.niveau)) {
+    fprintf(stderr,
+            "%s : niveau trop grand pour le solveur (%d cases au plus)\n",
+            fichier, MAX_CASES);
+    return EXIT_FAILURE;
+  }
+  init_position(&plateau, &solveur.niveau, &position);
+  if ((position.joueur == AUCUNE_CASE) ||
+      (position.nbCaisses < solveur.niveau.nbCibles) ||
+      (solveur.niveau.nbCibles > MAX_CAISSES)) {
+    fprintf(stderr, "%s : niveau invalide\n", fichier);
+    return EXIT_FAILURE;
+  }
+  if ((options->nbThreads > 1) && (options->algorithme != ALGO_LARGEUR)) {
+    fprintf(stderr, "%s : %s ne sert qu'à la recherche en largeur, un seul "
+                    "thread\n", fichier, OPTION_THREADS);
+  }
+  if (options->algorithme == ALGO_DISQUE) {
+    // la mémoire autorisée sert de tampon de tri, pas de table en mémoire
+    nbPoussees = recherche_disque(&solveur.niveau, &position, options->dossier,
+                                  memoireMo, echeance, depart, arrivee,
+                                  &solveur.noeudsDeveloppes, &horsDelai);
+    if (horsDelai) {
+      fprintf(stderr, "%s : temps dépassé (%ld s, %ld noeuds)\n", fichier,
+              options->tempsMax, solveur.noeudsDeveloppes);
+      return EXIT_FAILURE;
+    } else if (nbPoussees == AUCUNE_CASE) {
+      fprintf(stderr, "%s : pas de solution (%ld noeuds)\n", fichier,
+              solveur.noeudsDeveloppes);
+      return EXIT_FAILURE;
+    }
+    return ecrire_solution(&plateau, &plateauBase, &solveur.niveau, depart,
+                           arrivee, nbPoussees, fichier, options->compact,
+                           solveur.noeudsDeveloppes);
+  }
+  if (options->algorithme == ALGO_IDA) {
+    nbPoussees = recherche_ida(&solveur.niveau, &position, options->cacheMo,
+                               options->macros, echeance, depart, arrivee,
+                               &solveur.noeudsDeveloppes, &horsDelai);
+    if (horsDelai) {
+      fprintf(stderr, "%s : temps dépassé (%ld s, %ld noeuds)\n", fichier,
+              options->tempsMax, solveur.noeudsDeveloppes);
+      return EXIT_FAILURE;
+    } else if (nbPoussees == AUCUNE_CASE) {
+      fprintf(stderr, "%s : pas de solution (%ld noeuds)\n", fichier,
+              solveur.noeudsDeveloppes);
+      return EXIT_FAILURE;
+    }
+    return ecrire_solution(&plateau, &plateauBase, &solveur.niveau, depart,
+                           arrivee, nbPoussees, fichier, options->compact,
+                           solveur.noeudsDeveloppes);
+  }
+  if (bidirectionnel && (position.nbCaisses != solveur.niveau.nbCibles)) {
+    fprintf(stderr, "%s : plus de caisses que de cibles, recherche en "
+                    "largeur\n", fichier);
+    bidirectionnel = FAUX;
+  }
+  if (bidirectionnel) {
+    // la mémoire est partagée entre les deux recherches
+    memoireMo = (memoireMo > 1) ? memoireMo / 2 : 1;
+    if (!init_solveur(&arriere, &solveur.niveau, position.nbCaisses,
+                      memoireMo)) {
+      fprintf(stderr, "%s : mémoire insuffisante\n", fichier);
+      return EXIT_FAILURE;
+    }
+  }
+  if (!init_solveur(&solveur, &solveur.niveau, position.nbCaisses,
+                    memoireMo)) {
+    fprintf(stderr, "%s : mémoire insuffisante\n", fichier);
+    if (bidirectionnel) {
+      liberer_solveur(&arriere);
+    }
+    return EXIT_FAILURE;
+  }
+  // échéance vérifiée par A* et la recherche en largeur
+  solveur.echeance = echeance;
+  if (bidirectionnel) {
+    but = recherche_bidirectionnelle(&solveur, &arriere, &position, &rencontre)
+              ? rencontre.avant
+              : AUCUNE_CASE;
+    solveur.memoirePleine = solveur.memoirePleine || arriere.memoirePleine;
+    solveur.nbNoeuds += arriere.nbNoeuds;
+    solveur.noeudsDeveloppes += arriere.noeudsDeveloppes;
+  } else if (options->algorithme == ALGO_ASTAR) {
+    solveur.macros = options->macros;
+    but = recherche_astar(&solveur, &position);
+  } else if ((options->algorithme == ALGO_LARGEUR) &&
+             (options->nbThreads > 1)) {
+    but = recherche_parallele(&solveur, &position, options->nbThreads);
+  } else {
+    but = recherche_largeur(&solveur, &position);
+  }
+  if (solveur.horsDelai) {
+    fprintf(stderr, "%s : temps dépassé (%ld s, %ld noeuds)\n", fichier,
+            options->tempsMax, solveur.noeudsDeveloppes);
+  } else if (solveur.memoirePleine) {
+    fprintf(stderr, "%s : mémoire insuffisante (%d états, %ld Mo)\n",
+            fichier, solveur.nbNoeuds, options->memoireMo);
+  } else if (but == AUCUNE_CASE) {
+    fprintf(stderr, "%s : pas de solution (%ld noeuds)\n", fichier,
+            solveur.noeudsDeveloppes);
+  } else {
+    nbPoussees = bidirectionnel ? extraire_rencontre(&solveur, &arriere,
+                                                     &rencontre, depart,
+                                                     arrivee)
+                                : extraire_poussees(&solveur, but, depart,
+                                                    arrivee);
+    resultat = ecrire_solution(&plateau, &plateauBase, &solveur.niveau, depart,
+                               arrivee, nbPoussees, fichier,
+                               options->compact, solveur.noeudsDeveloppes);
+  }
+  liberer_solveur(&solveur);
+  if (bidirectionnel) {
+    liberer_solveur(&arriere);
+  }
+  return resultat;
+}
+
+/**
+ * @brief Fonction qui rejoue les poussées de la solution sur le plateau et
+ * écrit les déplacements (hbgdHBGD) sur la sortie standard. Les macro-coups
+ * sont d'abord remplacés par des poussées d'une case.
+ * @param plateau t_plateau, plateau de jeu à la position de départ
+ * @param plateauBase t_plateau, plateau de base du niveau
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart tableau des cases de départ des caisses
+ * @param arrivee tableau des cases d'arrivée des caisses
+ * @param nbPoussees int, nombre de coups
+ * @param fichier chaîne, nom du niveau pour les messages
+ * @param compact chaîne, fichier .dpk où écrire aussi la solution, ou NULL
+ * @param noeudsDeveloppes long, nombre de positions développées
+ * @return EXIT_SUCCESS si la solution a pu être rejouée
+ */
+int ecrire_solution(t_plateau *plateau, t_plateau *plateauBase,
+    const t_niveau *niveau, short depart[], short arrivee[], int nbPoussees,
+    const char *fichier, const char *compact, long noeudsDeveloppes) {
+  t_historique historique;
+  int nbDeplacement = 0;
+  FILE *f;
+  init_historique(&historique);
+  nbPoussees = developper_macros(plateau, niveau, depart, arrivee, nbPoussees);
+  if ((nbPoussees == AUCUNE_CASE) ||
+      !construire_deplacements(plateau, plateauBase, niveau, depart, arrivee,
+                               nbPoussees, &historique, &nbDeplacement)) {
+    fprintf(stderr, "%s : solution trop longue pour être rejouée\n",
+            fichier);
+    liberer_historique(&historique);
+    return EXIT_FAILURE;
+  }
+  ecrire_historique(&historique, nbDeplacement, stdout);
+  printf("\n");
+  if (compact != NULL) {
+    f = fopen(compact, "wb");
+    if (f == NULL) {
+      printf("ERREUR SUR FICHIER");
+      exit(EXIT_FAILURE);
+    }
+    ecrire_compact(&historique, nbDeplacement, f);
+    fclose(f);
+  }
+  liberer_historique(&historique);
+  fprintf(stderr, "%s : %d poussées, %d déplacements (%ld noeuds)\n",
+          fichier, nbPoussees, nbDeplacement, noeudsDeveloppes);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Fonction qui raccourcit une liste de déplacements (.dep) : les
+ * poussées sont extraites puis améliorées fenêtre par fenêtre, la marche entre
+ * deux poussées est refaite par le plus court chemin à l'écriture. Les
+ * déplacements obtenus sont écrits sur la sortie standard (hbgdHBGD).
+ * @param options t_options, fichiers .sok et .dep, taille des fenêtres
+ * @return EXIT_SUCCESS si les déplacements résolvent le niveau
+ */
+int optimiser_fichier(const t_options *options) {
+  char *fichier = options->fichier;
+  t_plateau plateau, plateauBase;
+  t_historique historique;
+  t_niveau niveau;
+  t_position position;
+  short *depart, *arrivee;
+  int nbDeplacement, nbPoussees = 0, resultat;
+  long noeudsDeveloppes;
+
+  charger_partie(&plateau, fichier);
+  separer_couches(&plateau, &plateauBase);
+  if (!analyser_niveau(&plateau, &plateauBase, &niveau)) {
+    fprintf(stderr,
+            "%s : niveau trop grand pour le solveur (%d cases au plus)\n",
+            fichier, MAX_CASES);
+    return EXIT_FAILURE;
+  }
+  init_position(&plateau, &niveau, &position);
+  if ((position.joueur == AUCUNE_CASE) ||
+      (position.nbCaisses < niveau.nbCibles) ||
+      (niveau.nbCibles > MAX_CAISSES)) {
+    fprintf(stderr, "%s : niveau invalide\n", fichier);
+    return EXIT_FAILURE;
+  }
+  init_historique(&historique);
+  nbDeplacement = lire_deplacements(&historique, options->deplacements);
+  // une case de départ et d'arrivée par poussée du fichier, sans limite
+  for (int i = 0; i < nbDeplacement; i++) {
+    nbPoussees += deplacement_avec_caisse(coup_historique(&historique, i));
+  }
+  depart = malloc((nbPoussees + 1) * sizeof(short));
+  arrivee = malloc((nbPoussees + 1) * sizeof(short));
+  if ((depart == NULL) || (arrivee == NULL)) {
+    printf("ERREUR MEMOIRE");
+    exit(EXIT_FAILURE);
+  }
+  nbPoussees = extraire_deplacements(&position, &niveau, &historique,
+                                     nbDeplacement, depart, arrivee);
+  liberer_historique(&historique);
+  if ((nbPoussees == AUCUNE_CASE) ||
+      !position_gagnante(&position, &niveau)) {
+    fprintf(stderr, "%s : %s ne résout pas le niveau\n", fichier,
+            options->deplacements);
+    free(depart);
+    free(arrivee);
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%s : %d poussées, %d déplacements au départ\n", fichier,
+          nbPoussees, nbDeplacement);
+  init_position(&plateau, &niveau, &position);
+  nbPoussees = optimiser_poussees(&position, &niveau, depart, arrivee,
+                                  nbPoussees, options->fenetre,
+                                  &noeudsDeveloppes);
+  resultat = ecrire_solution(&plateau, &plateauBase, &niveau, depart, arrivee,
+                             nbPoussees, fichier, options->compact,
+                             noeudsDeveloppes);
+  free(depart);
+  free(arrivee);
+  return resultat;
+}
+
+/**
+ * @brief Fonction qui résout tous les niveaux .sok d'un dossier avec A*, sur
+ * plusieurs threads, avec une limite de temps par niveau ; la mémoire
+ * autorisée est partagée entre les threads. Un fichier illisible est noté
+ * invalide sans arrêter le lot. Le résultat est écrit en CSV sur la sortie
+ * standard, une ligne par niveau dans l'ordre des noms.
+ * @param options t_options, dossier, threads, mémoire du lot et temps par
+ * niveau
+ * @return EXIT_SUCCESS si tous les niveaux sont résolus
+ */
+int resoudre_dossier(const t_options *options) {
+  t_lot lot;
+  t_options parNiveau = *options;
+  pthread_t *threads;
+  int nbThreads = options->nbThreads, resolus = 0, lances = 0;
+
+  lot.options = &parNiveau;
+  lot.nbFichiers = lister_niveaux(options->fichier, &lot.fichiers);
+  lot.suivant = 0;
+  lot.resultats = calloc(lot.nbFichiers + 1, sizeof(t_resultat));
+  nbThreads = (nbThreads < lot.nbFichiers) ? nbThreads : lot.nbFichiers;
+  // --memoire est la mémoire de tout le lot, partagée entre les threads
+  if (nbThreads > 1) {
+    parNiveau.memoireMo = options->memoireMo / nbThreads;
+    parNiveau.memoireMo = (parNiveau.memoireMo > 0) ? parNiveau.memoireMo : 1;
+  }
+  threads = malloc((nbThreads + 1) * sizeof(pthread_t));
+  if ((lot.resultats == NULL) || (threads == NULL)) {
+    fprintf(stderr, "%s : mémoire insuffisante\n", options->fichier);
+    return EXIT_FAILURE;
+  }
+  // chaque thread prend le niveau suivant : ceux qui ont pu être lancés
+  // finissent le lot
+  while ((lances < nbThreads) &&
+         (pthread_create(&threads[lances], NULL, travailleur_lot, &lot) == 0)) {
+    lances++;
+  }
+  if ((lances == 0) && (lot.nbFichiers > 0)) {
+    fprintf(stderr, "impossible de lancer %d threads\n", nbThreads);
+    exit(EXIT_FAILURE);
+  }
+  for (int t = 0; t < lances; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  printf("niveau,statut,deplacements,poussees,noeuds,temps_ms,memoire_ko\n");
+  for (int i = 0; i < lot.nbFichiers; i++) {
+    t_resultat *resultat = &lot.resultats[i];
+    printf("%s,%s,%d,%d,%ld,%ld,%ld\n", lot.fichiers[i], resultat->statut,
+           resultat->deplacements, resultat->poussees, resultat->noeuds,
+           resultat->tempsMs, resultat->memoireKo);
+    resolus += (strcmp(resultat->statut, STATUT_RESOLU) == 0);
+    free(lot.fichiers[i]);
+  }
+  fprintf(stderr, "%s : %d niveaux résolus sur %d\n", options->fichier,
+          resolus, lot.nbFichiers);
+  free(lot.fichiers);
+  free(lot.resultats);
+  free(threads);
+  return (resolus == lot.nbFichiers) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Fonction qui liste les fichiers .sok d'un dossier (ceux que montre
+ * affiche_niveau() dans le dossier courant), triés par nom.
+ * @param dossier chaîne, le dossier
+ * @param fichiers tableau des noms alloué, en sortie
+ * @return le nombre de fichiers
+ */
+int lister_niveaux(const char *dossier, char ***fichiers) {
+  DIR *d = opendir(dossier);
+  struct dirent *entree;
+  char **noms;
+  int nb = 0, capacite = 16;
+  size_t longueur, extension = strlen(FICHIER_SOK);
+  if (d == NULL) {
+    fprintf(stderr, "ERREUR SUR FICHIER %s\n", dossier);
+    exit(EXIT_FAILURE);
+  }
+  *fichiers = malloc(capacite * sizeof(char *));
+  if (*fichiers == NULL) {
+    printf("ERREUR MEMOIRE");
+    exit(EXIT_FAILURE);
+  }
+  while ((entree = readdir(d)) != NULL) {
+    longueur = strlen(entree->d_name);
+    if ((longueur <= extension) ||
+        (strcmp(entree->d_name + longueur - extension, FICHIER_SOK) != 0)) {
+      continue;
+    }
+    if (nb == capacite) {
+      capacite *= 2;
+      noms = realloc(*fichiers, capacite * sizeof(char *));
+      if (noms == NULL) {
+        printf("ERREUR MEMOIRE");
+        exit(EXIT_FAILURE);
+      }
+      *fichiers = noms;
+    }
+    (*fichiers)[nb] = malloc(longueur + 1);
+    if ((*fichiers)[nb] == NULL) {
+      printf("ERREUR MEMOIRE");
+      exit(EXIT_FAILURE);
+    }
+    memcpy((*fichiers)[nb], entree->d_name, longueur + 1);
+    nb++;
+  }
+  closedir(d);
+  qsort(*fichiers, nb, sizeof(char *), comparer_noms);
+  return nb;
+}
+
+/**
+ * @brief Fonction de comparaison de qsort() pour trier des noms de fichiers.
+ * @param a pointeur sur un nom
+ * @param b pointeur sur un nom
+ */
+int comparer_noms(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Fonction d'un thread de resoudre_dossier() : prend le prochain
+ * niveau non traité tant qu'il en reste.
+ * @param argument t_lot
+ * @return NULL
+ */
+void *travailleur_lot(void *argument) {
+  t_lot *lot = argument;
+  t_resultat *resultat;
+  int i = __atomic_fetch_add(&lot->suivant, 1, __ATOMIC_RELAXED);
+  while (i < lot->nbFichiers) {
+    resultat = &lot->resultats[i];
+    resoudre_niveau(lot->options, lot->fichiers[i], resultat);
+    fprintf(stderr, "%s : %s, %d poussées, %ld ms\n", lot->fichiers[i],
+            resultat->statut, resultat->poussees, resultat->tempsMs);
+    i = __atomic_fetch_add(&lot->suivant, 1, __ATOMIC_RELAXED);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Procédure qui résout un niveau du dossier avec A* et note le
+ * résultat, sans rien écrire.
+ * @param options t_options, dossier, mémoire et temps par niveau
+ * @param nom chaîne, nom du fichier .sok dans le dossier
+ * @param resultat t_resultat, en sortie
+ */
+void resoudre_niveau(const t_options *options, const char *nom,
+    t_resultat *resultat) {
+  char chemin[TAILLE_NOM_DISQUE];
+  t_plateau plateau, plateauBase;
+  long debut = maintenant_ms();
+
+  snprintf(chemin, sizeof(chemin), "%s/%s", options->fichier, nom);
+  if (!lire_niveau(&plateau, chemin)) {
+    // pas d'arrêt du programme depuis un thread : le lot continue
+    memset(resultat, 0, sizeof(t_resultat));
+    resultat->statut = STATUT_INVALIDE;
+    resultat->tempsMs = maintenant_ms() - debut;
+    return;
+  }
+  separer_couches(&plateau, &plateauBase);
+  resoudre_plateau(&plateau, &plateauBase, options, ALGO_ASTAR, resultat);
+  resultat->tempsMs = maintenant_ms() - debut;
+}
+
+/**
+ * @brief Procédure qui résout un plateau en largeur ou avec A* et note le
+ * résultat, sans rien écrire.
+ * @param plateau t_plateau, plateau de jeu (modifié)
+ * @param plateauBase t_plateau, plateau de base du niveau
+ * @param options t_options, mémoire et temps par niveau
+ * @param algorithme int, ALGO_LARGEUR ou ALGO_ASTAR
+ * @param resultat t_resultat, en sortie
+ */
+void resoudre_plateau(t_plateau *plateau, t_plateau *plateauBase,
+    const t_options *options, int algorithme, t_resultat *resultat) {
+  t_historique historique;
+  // sur le tas : resoudre_niveau() tourne sur les threads de --solve-all
+  t_solveur *solveur = malloc(sizeof(t_solveur));
+  t_position position;
+  short depart[TAILLE_DEPLACEMENT], arrivee[TAILLE_DEPLACEMENT];
+  long debut = maintenant_us();
+  int but, nbPoussees;
+
+  resultat->statut = STATUT_INVALIDE;
+  resultat->deplacements = 0;
+  resultat->poussees = 0;
+  resultat->noeuds = 0;
+  resultat->etats = 0;
+  resultat->memoireKo = 0;
+  resultat->rechercheUs = 0;
+  if (solveur == NULL) {
+    resultat->statut = STATUT_MEMOIRE;
+    return;
+  }
+  if (!analyser_niveau(plateau, plateauBase, &solveur->niveau)) {
+    resultat->statut = STATUT_TROP_GRAND;
+    free(solveur);
+    return;
+  }
+  init_position(plateau, &solveur->niveau, &position);
+  if ((position.joueur == AUCUNE_CASE) ||
+      (position.nbCaisses < solveur->niveau.nbCibles) ||
+      (solveur->niveau.nbCibles > MAX_CAISSES)) {
+    free(solveur);
+    return;
+  }
+  if (!init_solveur(solveur, &solveur->niveau, position.nbCaisses,
+                    options->memoireMo)) {
+    resultat->statut = STATUT_MEMOIRE;
+    free(solveur);
+    return;
+  }
+  solveur->echeance = (options->tempsMax > 0)
+                          ? debut / 1000 + options->tempsMax * 1000
+                          : 0;
+  but = (algorithme == ALGO_ASTAR) ? recherche_astar(solveur, &position)
+                                   : recherche_largeur(solveur, &position);
+  resultat->rechercheUs = maintenant_us() - debut;
+  resultat->noeuds = solveur->noeudsDeveloppes;
+  resultat->etats = solveur->nbNoeuds;
+  resultat->memoireKo = (long)(memoire_solveur(solveur) / 1024);
+  if (solveur->horsDelai) {
+    resultat->statut = STATUT_TEMPS;
+  } else if (solveur->memoirePleine) {
+    resultat->statut = STATUT_MEMOIRE;
+  } else if (but == AUCUNE_CASE) {
+    resultat->statut = STATUT_SANS_SOLUTION;
+  } else {
+    nbPoussees = extraire_poussees(solveur, but, depart, arrivee);
+    resultat->poussees = nbPoussees;
+    resultat->statut = STATUT_TROP_LONG;
+    init_historique(&historique);
+    if (construire_deplacements(plateau, plateauBase, &solveur->niveau, depart,
+                                arrivee, nbPoussees, &historique,
+                                &resultat->deplacements)) {
+      resultat->statut = STATUT_RESOLU;
+    }
+    liberer_historique(&historique);
+  }
+  liberer_solveur(solveur);
+  free(solveur);
+}
+
+/**
+ * @brief Fonction du banc d'essai : niveaux fournis (niveau1.sok à
+ * niveau7.sok du dossier courant) et niveaux générés avec des graines fixes,
+ * chacun résolu en largeur puis avec A*. Les mesures sont écrites en CSV sur
+ * la sortie standard ; avec une base (CSV d'une exécution précédente) les
+ * écarts sont signalés sur la sortie d'erreur.
+ * @param options t_options, base à comparer, mémoire et temps par recherche
+ * @return EXIT_FAILURE si une régression est trouvée par rapport à la base
+ */
+int lancer_banc(const t_options *options) {
+  char nom[TAILLE_NOM_DISQUE];
+  t_plateau plateau, plateauBase, depart;
+  t_resultat resultat;
+  t_mesure *base = NULL;
+  int nbBase = 0, regressions = 0;
+  int algorithmes[2] = {ALGO_LARGEUR, ALGO_ASTAR};
+  FILE *f;
+
+  if (options->base != NULL) {
+    nbBase = lire_base(options->base, &base);
+  }
+  printf("niveau,algo,statut,poussees,noeuds,etats,octets_par_etat,"
+         "temps_us,noeuds_par_s\n");
+  for (int n = 1; n <= NB_NIVEAUX_BANC + NB_SYNTHETIQUES; n++) {
+    if (n <= NB_NIVEAUX_BANC) {
+      snprintf(nom, sizeof(nom), "niveau%d%s", n, FICHIER_SOK);
+      f = fopen(nom, "r");
+      if (f == NULL) {
+        fprintf(stderr, "%s : absent, ignoré\n", nom);
+        continue;
+      }
+      fclose(f);
+      charger_partie(&depart, nom);
+      separer_couches(&depart, &plateauBase);
+    } else {
+      snprintf(nom, sizeof(nom), "synthetique%d", n - NB_NIVEAUX_BANC);
+      generer_niveau(GRAINE_BANC + n, &depart, &plateauBase);
+    }
+    for (int a = 0; a < 2; a++) {
+      plateau = depart;
+      resoudre_plateau(&plateau, &plateauBase, options, algorithmes[a],
+                       &resultat);
+      regressions += ecrire_mesure(nom, algorithmes[a], &resultat, base,
+                                   nbBase);
+    }
+  }
+  free(base);
+  if (options->base != NULL) {
+    fprintf(stderr, "%d régression(s) par rapport à %s\n", regressions,
+            options->base);
+  }
+  return (regressions == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Procédure qui génère un niveau jouable à partir d'une graine : pièce
+ * de 10 x 10 avec des murs au hasard, caisses posées sur les cibles puis
+ * tirées au hasard (chaque tirage est une poussée à l'envers, le niveau a donc
+ * une solution).
+ * @param graine uint64_t, la même graine donne le même niveau
+ * @param plateau t_plateau, caisses et joueur, en sortie
+ * @param plateauBase t_plateau, murs et cibles, en sortie
+ */
+void generer_niveau(uint64_t graine, t_plateau *plateau,
+    t_plateau *plateauBase) {
+  t_niveau *niveau = malloc(sizeof(t_niveau));
+  t_position position;
+  t_poussee tirages[NB_DIRECTIONS * MAX_CAISSES];
+  t_masque atteint;
+  short libres[MAX_CASES];
+  int nbLibres = 0, nbCaisses, laCase, nb;
+  int centre = (TAILLE_GENERE / 2) * TAILLE_GENERE + TAILLE_GENERE / 2;
+
+  if (niveau == NULL) {
+    printf("ERREUR MEMOIRE");
+    exit(EXIT_FAILURE);
+  }
+  // pièce fermée, 1 case sur 6 en mur, sauf la partie reliée au centre
+  plateau->hauteur = TAILLE_GENERE;
+  plateau->largeur = TAILLE_GENERE;
+  plateauBase->hauteur = TAILLE_GENERE;
+  plateauBase->largeur = TAILLE_GENERE;
+  memset(plateau->cases, VIDE, TAILLE_GENERE * TAILLE_GENERE);
+  for (int ligne = 0; ligne < TAILLE_GENERE; ligne++) {
+    for (int colonne = 0; colonne < TAILLE_GENERE; colonne++) {
+      bool bord = (ligne <= 0) || (ligne >= TAILLE_GENERE - 1) ||
+                  (colonne <= 0) || (colonne >= TAILLE_GENERE - 1);
+      plateauBase->cases[ligne * TAILLE_GENERE + colonne] =
+          (bord || (alea_zobrist(&graine) % 6 == 0)) ? BORD : VIDE;
+    }
+  }
+  plateauBase->cases[centre] = VIDE;
+  plateau->cases[centre] = JOUEUR;
+  analyser_niveau(plateau, plateauBase, niveau);
+  init_position(plateau, niveau, &position);
+  acces_joueur(&position, niveau, atteint);
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (!niveau->mur[laCase] && !masque_contient(atteint, laCase)) {
+      plateauBase->cases[laCase] = BORD;
+    } else if (!niveau->mur[laCase]) {
+      libres[nbLibres++] = laCase;
+    }
+  }
+  // cibles au hasard, chacune avec sa caisse
+  nbCaisses = 3 + (int)(graine % 3);
+  for (int c = 0; (c < nbCaisses) && (nbLibres > 1); c++) {
+    int i = (int)(alea_zobrist(&graine) % (uint64_t)nbLibres);
+    laCase = libres[i];
+    libres[i] = libres[--nbLibres];
+    plateauBase->cases[laCase] = CIBLE;
+    plateau->cases[laCase] = CAISSE;
+  }
+  // le joueur du centre n'a servi qu'à trouver la partie accessible
+  if (plateau->cases[centre] == JOUEUR) {
+    plateau->cases[centre] = VIDE;
+  }
+  // joueur au hasard, tiré de nouveau s'il est enfermé par les caisses sans
+  // pouvoir en tirer aucune : le niveau serait déjà résolu
+  nb = 0;
+  for (int essai = 0; (essai < nbLibres) && (nb == 0); essai++) {
+    if (essai > 0) {
+      plateau->cases[laCase] = VIDE;
+    }
+    laCase = libres[alea_zobrist(&graine) % (uint64_t)nbLibres];
+    plateau->cases[laCase] = JOUEUR;
+    analyser_niveau(plateau, plateauBase, niveau);
+    init_position(plateau, niveau, &position);
+    acces_joueur(&position, niveau, atteint);
+    nb = lister_tirages(&position, niveau, atteint, tirages);
+  }
+  // tirages au hasard depuis la position gagnante
+  for (int t = 0; t < TIRAGES_BANC; t++) {
+    acces_joueur(&position, niveau, atteint);
+    nb = lister_tirages(&position, niveau, atteint, tirages);
+    if (nb == 0) {
+      break;
+    }
+    tirer_caisse(&position, niveau,
+                 tirages[alea_zobrist(&graine) % (uint64_t)nb]);
+  }
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    plateau->cases[laCase] = est_caisse(position.cases[laCase]) ? CAISSE
+                                                                 : VIDE;
+  }
+  plateau->cases[position.joueur] = JOUEUR;
+  plateau->ciblesLibres = compter_cibles_libres(plateau, plateauBase);
+  indexer_caisses(plateau);
+  free(niveau);
+}
+
+/**
+ * @brief Fonction qui écrit la ligne CSV d'une mesure et la compare à la base
+ * si elle y figure : les noeuds et positions doivent être les mêmes (les
+ * recherches sont déterministes), la vitesse ne doit pas baisser de plus de
+ * SEUIL_REGRESSION % quand la mesure est assez longue pour être fiable.
+ * @param nom chaîne, nom du niveau
+ * @param algorithme int, ALGO_LARGEUR ou ALGO_ASTAR
+ * @param resultat t_resultat, la mesure
+ * @param base tableau des mesures de la base
+ * @param nbBase int, nombre de mesures de la base
+ * @return 1 si la mesure est une régression, 0 sinon
+ */
+int ecrire_mesure(const char *nom, int algorithme, const t_resultat *resultat,
+    const t_mesure *base, int nbBase) {
+  const char *algo = (algorithme == ALGO_ASTAR) ? "astar" : "largeur";
+  long vitesse = (resultat->rechercheUs > 0)
+                     ? (long)(resultat->noeuds * 1000000.0 /
+                              resultat->rechercheUs)
+                     : 0;
+  long octets = (resultat->etats > 0)
+                    ? resultat->memoireKo * 1024L / resultat->etats
+                    : 0;
+  int regression = 0;
+  printf("%s,%s,%s,%d,%ld,%d,%ld,%ld,%ld\n", nom, algo, resultat->statut,
+         resultat->poussees, resultat->noeuds, resultat->etats, octets,
+         resultat->rechercheUs, vitesse);
+  for (int i = 0; i < nbBase; i++) {
+    const t_mesure *ancienne = &base[i];
+    if ((strcmp(ancienne->niveau, nom) != 0) ||
+        (strcmp(ancienne->algo, algo) != 0)) {
+      continue;
+    }
+    // une recherche coupée par le temps n'est pas reproductible
+    if ((strcmp(ancienne->statut, STATUT_TEMPS) != 0) &&
+        (strcmp(resultat->statut, STATUT_TEMPS) != 0) &&
+        ((strcmp(ancienne->statut, resultat->statut) != 0) ||
+         (ancienne->poussees != resultat->poussees) ||
+         (ancienne->noeuds != resultat->noeuds))) {
+      fprintf(stderr, "%s %s : RÉGRESSION %s %d poussées %ld noeuds, base "
+                      "%s %d poussées %ld noeuds\n",
+              nom, algo, resultat->statut, resultat->poussees,
+              resultat->noeuds, ancienne->statut, ancienne->poussees,
+              ancienne->noeuds);
+      regression = 1;
+    } else if ((resultat->rechercheUs >= DUREE_MESURE_US) &&
+               (ancienne->tempsUs >= DUREE_MESURE_US)) {
+      long ecart = (vitesse - ancienne->vitesse) * 100 /
+                   (ancienne->vitesse > 0 ? ancienne->vitesse : 1);
+      fprintf(stderr, "%s %s : %ld noeuds/s, base %ld (%+ld %%)%s\n", nom,
+              algo, vitesse, ancienne->vitesse, ecart,
+              (ecart < -SEUIL_REGRESSION) ? " RÉGRESSION" : "");
+      regression = (ecart < -SEUIL_REGRESSION);
+    }
+  }
+  return regression;
+}
+
+/**
+ * @brief Fonction qui lit un fichier de base du banc d'essai (CSV écrit par
+ * une exécution précédente de --bench).
+ * @param fichier chaîne, nom du fichier
+ * @param base tableau des mesures alloué, en sortie
+ * @return le nombre de mesures lues
+ */
+int lire_base(const char *fichier, t_mesure **base) {
+  FILE *f = fopen(fichier, "r");
+  char ligne[TAILLE_NOM_DISQUE];
+  int nb = 0, capacite = 32;
+  t_mesure mesure, *mesures;
+  long octets;
+  if (f == NULL) {
+    fprintf(stderr, "ERREUR SUR FICHIER %s\n", fichier);
+    exit(EXIT_FAILURE);
+  }
+  *base = malloc(capacite * sizeof(t_mesure));
+  if (*base == NULL) {
+    printf("ERREUR MEMOIRE");
+    exit(EXIT_FAILURE);
+  }
+  while (fgets(ligne, sizeof(ligne), f) != NULL) {
+    // la ligne d'en-tête ne passe pas
+    if (sscanf(ligne, "%63[^,],%15[^,],%15[^,],%d,%ld,%d,%ld,%ld,%ld",
+               mesure.niveau, mesure.algo, mesure.statut, &mesure.poussees,
+               &mesure.noeuds, &mesure.etats, &octets, &mesure.tempsUs,
+               &mesure.vitesse) != 9) {
+      continue;
+    }
+    if (nb == capacite) {
+      capacite *= 2;
+      mesures = realloc(*base, capacite * sizeof(t_mesure));
+      if (mesures == NULL) {
+        printf("ERREUR MEMOIRE");
+        exit(EXIT_FAILURE);
+      }
+      *base = mesures;
+    }
+    (*base)[nb++] = mesure;
+  }
+  fclose(f);
+  return nb;
+}
+
+/**
+ * @brief Fonction qui donne l'heure d'une horloge monotone.
+ * @return le temps en millisecondes
+ */
+long maintenant_ms() { return maintenant_us() / 1000; }
+
+/**
+ * @brief Fonction qui donne l'heure d'une horloge monotone.
+ * @return le temps en microsecondes
+ */
+long maintenant_us() {
+  struct timespec instant;
+  clock_gettime(CLOCK_MONOTONIC, &instant);
+  return instant.tv_sec * 1000000L + instant.tv_nsec / 1000L;
+}
+
+/**
+ * @brief Fonction qui donne la mémoire dont la recherche a eu besoin : noeuds
+ * alloués (les tableaux ne font que grandir, c'est donc le pic) et table de
+ * transposition remplie aux 3/4 au plus, comme le permet init_solveur().
+ * @param solveur t_solveur
+ * @return la mémoire en octets
+ */
+size_t memoire_solveur(const t_solveur *solveur) {
+  return solveur->table.nbEntrees * (sizeof(uint64_t) + sizeof(int)) / 3 * 4 +
+         (size_t)solveur->capacite *
+             (sizeof(t_noeud) + solveur->nbCaisses * sizeof(short));
+}
+
+/**
+ * @brief Fonction qui lit un fichier de déplacements : texte (.dep), les
+ * caractères autres que hbgdHBGD sont ignorés, ou compact (.dpk, reconnu à
+ * son entête). Le nombre de déplacements n'est pas limité.
+ * @param historique t_historique, vide en entrée, déplacements en sortie
+ * @param fic string, nom du fichier
+ * @return le nombre de déplacements lus
+ */
+int lire_deplacements(t_historique *historique, char fic[]) {
+  FILE *f;
+  char entete[sizeof(ENTETE_COMPACT)] = "";
+  uint8_t nombre[4] = {0};
+  uint8_t octets[OCTETS_MORCEAU] = {0};
+  int nb = 0, total = 0, c, lus, morceau;
+  int taille = (int)strlen(ENTETE_COMPACT);
+
+  f = fopen(fic, "rb");
+  if (f == NULL) {
+    printf("ERREUR SUR FICHIER");
+    exit(EXIT_FAILURE);
+  }
+  if ((fread(entete, sizeof(char), taille, f) == (size_t)taille) &&
+      (strcmp(entete, ENTETE_COMPACT) == 0)) {
+    // format .dpk : nombre de coups puis codes sur 3 bits
+    if (fread(nombre, sizeof(uint8_t), 4, f) == 4) {
+      total = nombre[0] | (nombre[1] << 8) | (nombre[2] << 16) |
+              ((int)nombre[3] << 24);
+    }
+    // TAILLE_MORCEAU est un multiple de 8 : le fichier se lit morceau par
+    // morceau comme ecrire_compact() l'a écrit
+    while (nb < total) {
+      morceau = (total - nb < TAILLE_MORCEAU) ? total - nb : TAILLE_MORCEAU;
+      lus = (int)fread(octets, sizeof(uint8_t), (morceau * BITS_COUP + 7) / 8,
+                       f);
+      if (lus * 8 / BITS_COUP < morceau) {
+        // fichier tronqué : coups complets seulement
+        morceau = lus * 8 / BITS_COUP;
+        total = nb + morceau;
+      }
+      for (int i = 0; i < morceau; i++) {
+        ecrire_coup(historique, nb++, CARACTERES_COUPS[lire_code(octets, i)]);
+      }
+    }
+  } else {
+    rewind(f);
+    while ((c = fgetc(f)) != EOF) {
+      if (direction_deplacement(c) != AUCUNE_CASE) {
+        ecrire_coup(historique, nb++, c);
+      }
+    }
+  }
+  fclose(f);
+  return nb;
+}
+
+/**
+ * @brief Fonction qui donne la direction du solveur d'un caractère de
+ * déplacement.
+ * @param c char, caractère du fichier .dep
+ * @return 0 haut, 1 bas, 2 gauche, 3 droite, AUCUNE_CASE si le caractère
+ * n'est pas un déplacement
+ */
+int direction_deplacement(char c) {
+  int direction = AUCUNE_CASE;
+  if ((c == HAUT_SANS_CAISSE) || (c == HAUT_AVEC_CAISSE)) {
+    direction = 0;
+  } else if ((c == BAS_SANS_CAISSE) || (c == BAS_AVEC_CAISSE)) {
+    direction = 1;
+  } else if ((c == GAUCHE_SANS_CAISSE) || (c == GAUCHE_AVEC_CAISSE)) {
+    direction = 2;
+  } else if ((c == DROITE_SANS_CAISSE) || (c == DROITE_AVEC_CAISSE)) {
+    direction = 3;
+  }
+  return direction;
+}
+
+/**
+ * @brief Fonction qui rejoue des déplacements sur la position de travail et
+ * garde seulement les poussées.
+ * @param position t_position, position de départ, position finale en sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param historique t_historique, déplacements hbgdHBGD
+ * @param nb int, nombre de déplacements
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @return le nombre de poussées, AUCUNE_CASE si un déplacement est impossible
+ */
+int extraire_deplacements(t_position *position, const t_niveau *niveau,
+    const t_historique *historique, int nb, short depart[], short arrivee[]) {
+  int nbPoussees = 0, d, devant;
+  bool avecCaisse;
+  char coup;
+  for (int i = 0; i < nb; i++) {
+    coup = coup_historique(historique, i);
+    d = direction_deplacement(coup);
+    if (d == AUCUNE_CASE) {
+      return AUCUNE_CASE;
+    }
+    avecCaisse = deplacement_avec_caisse(coup);
+    devant = position->joueur + niveau->decalage[d];
+    if (avecCaisse && est_caisse(position->cases[devant]) &&
+        est_libre(position->cases[devant + niveau->decalage[d]])) {
+      depart[nbPoussees] = devant;
+      arrivee[nbPoussees] = devant + niveau->decalage[d];
+      pousser_caisse(position, niveau, depart[nbPoussees],
+                     arrivee[nbPoussees]);
+      nbPoussees++;
+    } else if (!avecCaisse && est_libre(position->cases[devant])) {
+      position->joueur = devant;
+    } else {
+      return AUCUNE_CASE;
+    }
+  }
+  return nbPoussees;
+}
+
+/**
+ * @brief Fonction qui améliore une suite de poussées d'une case : pour chaque
+ * fenêtre de poussées consécutives, on cherche une autre suite d'au plus
+ * autant de poussées qui mène aux mêmes caisses avec moins de déplacements
+ * (marche comprise jusqu'à la poussée suivante). Une fenêtre améliorée est
+ * remplacée puis examinée de nouveau.
+ * @param position t_position, position de départ (modifiée)
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart tableau des cases de départ des caisses, en entrer et sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en entrer et sortie
+ * @param nbPoussees int, nombre de poussées
+ * @param taille int, nombre de poussées d'une fenêtre
+ * @param noeudsDeveloppes long, nombre de positions développées, en sortie
+ * @return le nouveau nombre de poussées
+ */
+int optimiser_poussees(t_position *position, const t_niveau *niveau,
+    short depart[], short arrivee[], int nbPoussees, int taille,
+    long *noeudsDeveloppes) {
+  t_fenetre fenetre;
+  t_position fin;
+  int p = 0, nb;
+  fenetre.niveau = niveau;
+  fenetre.position = position;
+  fenetre.noeudsDeveloppes = 0;
+  while (p < nbPoussees) {
+    nb = (nbPoussees - p < taille) ? nbPoussees - p : taille;
+    fin = *position;
+    for (int i = p; i < p + nb; i++) {
+      pousser_caisse(&fin, niveau, depart[i], arrivee[i]);
+    }
+    memcpy(fenetre.buts, fin.bitsCaisses, sizeof(t_masque));
+    fenetre.suivant = (p + nb < nbPoussees)
+                          ? 2 * depart[p + nb] - arrivee[p + nb]
+                          : AUCUNE_CASE;
+    fenetre.maxPoussees = nb;
+    fenetre.nbMeilleur = nb;
+    memcpy(fenetre.meilleurDepart, &depart[p], nb * sizeof(short));
+    memcpy(fenetre.meilleurArrivee, &arrivee[p], nb * sizeof(short));
+    fenetre.meilleurCout = cout_fenetre(position, niveau, &depart[p],
+                                        &arrivee[p], nb, fenetre.suivant);
+    fenetre.ameliore = FAUX;
+    explorer_fenetre(&fenetre, 0, 0);
+    if (fenetre.ameliore) {
+      // la fenêtre a au plus nb poussées, le reste recule
+      memmove(&depart[p + fenetre.nbMeilleur], &depart[p + nb],
+              (nbPoussees - p - nb) * sizeof(short));
+      memmove(&arrivee[p + fenetre.nbMeilleur], &arrivee[p + nb],
+              (nbPoussees - p - nb) * sizeof(short));
+      memcpy(&depart[p], fenetre.meilleurDepart,
+             fenetre.nbMeilleur * sizeof(short));
+      memcpy(&arrivee[p], fenetre.meilleurArrivee,
+             fenetre.nbMeilleur * sizeof(short));
+      nbPoussees += fenetre.nbMeilleur - nb;
+    } else {
+      pousser_caisse(position, niveau, depart[p], arrivee[p]);
+      p++;
+    }
+  }
+  *noeudsDeveloppes = fenetre.noeudsDeveloppes;
+  return nbPoussees;
+}
+
+/**
+ * @brief Fonction qui compte les déplacements d'une suite de poussées, marche
+ * par le plus court chemin comprise. La position est rendue inchangée.
+ * @param position t_position, position avant les poussées
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart tableau des cases de départ des caisses
+ * @param arrivee tableau des cases d'arrivée des caisses
+ * @param nb int, nombre de poussées
+ * @param suivant int, case où le joueur doit aller après la dernière poussée,
+ * AUCUNE_CASE si aucune
+ * @return le nombre de déplacements
+ */
+int cout_fenetre(const t_position *position, const t_niveau *niveau,
+    const short depart[], const short arrivee[], int nb, int suivant) {
+  t_position copie = *position;
+  short distance[MAX_CASES];
+  int cout = 0;
+  for (int i = 0; i < nb; i++) {
+    distances_joueur(&copie, niveau, distance);
+    cout += distance[2 * depart[i] - arrivee[i]] + 1;
+    pousser_caisse(&copie, niveau, depart[i], arrivee[i]);
+  }
+  if (suivant != AUCUNE_CASE) {
+    distances_joueur(&copie, niveau, distance);
+    cout += distance[suivant];
+  }
+  return cout;
+}
+
+/**
+ * @brief Procédure qui calcule la distance de marche du joueur jusqu'à chaque
+ * case sans pousser de caisse (parcours en largeur).
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param distance tableau des distances, INFINI_DISTANCE si la case n'est pas
+ * atteignable, en sortie
+ */
+void distances_joueur(const t_position *position, const t_niveau *niveau,
+    short distance[]) {
+  short file[MAX_CASES];
+  int debut = 0, fin = 0, laCase, voisine;
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    distance[laCase] = INFINI_DISTANCE;
+  }
+  distance[position->joueur] = 0;
+  file[fin++] = position->joueur;
+  while (debut < fin) {
+    laCase = file[debut++];
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      voisine = laCase + niveau->decalage[d];
+      if ((distance[voisine] == INFINI_DISTANCE) &&
+          est_libre(position->cases[voisine])) {
+        distance[voisine] = distance[laCase] + 1;
+        file[fin++] = voisine;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Procédure récursive de optimiser_poussees() : parcours en profondeur
+ * des suites de poussées de la fenêtre, coupé dès que les déplacements
+ * dépassent la meilleure suite connue.
+ * @param fenetre t_fenetre, état de la recherche
+ * @param profondeur int, nombre de poussées déjà jouées
+ * @param cout int, nombre de déplacements déjà faits
+ */
+void explorer_fenetre(t_fenetre *fenetre, int profondeur, int cout) {
+  const t_niveau *niveau = fenetre->niveau;
+  t_position *position = fenetre->position;
+  short distance[MAX_CASES];
+  int joueur = position->joueur, nbCaisses = position->nbCaisses;
+  int caisse, derriere, devant, suite, horsBut = 0;
+  short caisses[MAX_CAISSES];
+
+  fenetre->noeudsDeveloppes += 1;
+  distances_joueur(position, niveau, distance);
+  for (int m = 0; m < niveau->nbMots; m++) {
+    horsBut += __builtin_popcountll(position->bitsCaisses[m] &
+                                    ~fenetre->buts[m]);
+  }
+  if (horsBut == 0) {
+    suite = (fenetre->suivant == AUCUNE_CASE) ? 0
+                                              : distance[fenetre->suivant];
+    if (cout + suite < fenetre->meilleurCout) {
+      fenetre->meilleurCout = cout + suite;
+      fenetre->nbMeilleur = profondeur;
+      memcpy(fenetre->meilleurDepart, fenetre->depart,
+             profondeur * sizeof(short));
+      memcpy(fenetre->meilleurArrivee, fenetre->arrivee,
+             profondeur * sizeof(short));
+      fenetre->ameliore = VRAI;
+    }
+    return;
+  }
+  // chaque caisse hors de sa place demande encore au moins une poussée
+  if ((profondeur + horsBut > fenetre->maxPoussees) ||
+      (cout + horsBut >= fenetre->meilleurCout)) {
+    return;
+  }
+  memcpy(caisses, position->caisses, nbCaisses * sizeof(short));
+  for (int i = 0; i < nbCaisses; i++) {
+    caisse = caisses[i];
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      derriere = caisse - niveau->decalage[d];
+      devant = caisse + niveau->decalage[d];
+      if ((distance[derriere] == INFINI_DISTANCE) ||
+          !est_libre(position->cases[devant]) ||
+          masque_contient(niveau->casesMortes, devant) ||
+          (cout + distance[derriere] + 1 >= fenetre->meilleurCout)) {
+        continue;
+      }
+      fenetre->depart[profondeur] = caisse;
+      fenetre->arrivee[profondeur] = devant;
+      pousser_caisse(position, niveau, caisse, devant);
+      explorer_fenetre(fenetre, profondeur + 1,
+                       cout + distance[derriere] + 1);
+      pousser_caisse(position, niveau, devant, caisse);
+      position->joueur = joueur;
+    }
+  }
+}
+
+/**
+ * @brief Fonction qui extrait les murs et les cibles d'un plateau. Les cases
+ * sont numérotées comme celles du plateau, bord de sentinelles compris.
+ * @param plateau t_plateau, caisses et joueur au départ
+ * @param plateauBase t_plateau, murs et cibles du niveau
+ * @param niveau t_niveau, description fixe du niveau, en sortie
+ * @return FAUX si le plateau a plus de MAX_CASES cases : le niveau est alors
+ * vide (aucune case) et le solveur le refuse
+ */
+bool analyser_niveau(t_plateau *plateau, t_plateau *plateauBase,
+    t_niveau *niveau) {
+  char c;
+  niveau->largeur = plateauBase->largeur;
+  niveau->nbCases = plateauBase->hauteur * plateauBase->largeur;
+  niveau->nbCibles = 0;
+  niveau->nbSalles = 0;
+  niveau->nbListeCibles = 0;
+  niveau->decalage[0] = -niveau->largeur; // haut
+  niveau->decalage[1] = niveau->largeur;  // bas
+  niveau->decalage[2] = -1;               // gauche
+  niveau->decalage[3] = 1;                // droite
+  if (niveau->nbCases > MAX_CASES) {
+    niveau->nbCases = 0;
+    niveau->nbMots = 0;
+    return FAUX;
+  }
+  // les masques ne sont parcourus que sur les mots des cases du niveau : un
+  // petit niveau coûte autant qu'avant, quelle que soit la taille maximale
+  niveau->nbMots = (niveau->nbCases + 63) / 64;
+  uint64_t graine = GRAINE_ZOBRIST;
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    niveau->zobristCaisse[laCase] = alea_zobrist(&graine);
+    niveau->zobristJoueur[laCase] = alea_zobrist(&graine);
+  }
+  for (int m = 0; m < NB_MOTS; m++) {
+    niveau->murs[m] = 0;
+    niveau->cibles[m] = 0;
+  }
+  for (int laCase = niveau->nbCases; laCase < niveau->nbMots * 64; laCase++) {
+    masque_ajouter(niveau->murs, laCase);
+  }
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    c = plateauBase->cases[laCase];
+    // le bord de sentinelles est fait de murs : le solveur ne sort jamais du
+    // plateau
+    niveau->mur[laCase] = (c == BORD);
+    if (niveau->mur[laCase]) {
+      masque_ajouter(niveau->murs, laCase);
+    }
+    niveau->cible[laCase] = (c == CIBLE);
+    if (niveau->cible[laCase]) {
+      niveau->nbCibles += 1;
+      masque_ajouter(niveau->cibles, laCase);
+    }
+  }
+  calculer_cases_mortes(niveau);
+  calculer_distances(niveau);
+  calculer_tunnels(niveau);
+  calculer_salles(plateau, niveau);
+  return VRAI;
+}
+
+/**
+ * @brief Procédure qui calcule les cases mortes du niveau : depuis chaque
+ * cible on tire une caisse seule dans toutes les directions possibles (le
+ * joueur doit avoir une case libre derrière lui). Les cases jamais atteintes
+ * ne peuvent mener aucune caisse sur une cible, les autres caisses étant
+ * ignorées.
+ * @param niveau t_niveau, murs et cibles remplis, cases mortes en sortie
+ */
+void calculer_cases_mortes(t_niveau *niveau) {
+  bool vivante[MAX_CASES];
+  int file[MAX_CASES];
+  int debut = 0, fin = 0, laCase, caisse, joueur;
+  memset(vivante, FAUX, sizeof(vivante));
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (niveau->cible[laCase]) {
+      vivante[laCase] = VRAI;
+      file[fin++] = laCase;
+    }
+  }
+  while (debut < fin) {
+    laCase = file[debut++];
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      // le joueur tire la caisse d'une case dans la direction d
+      caisse = laCase + niveau->decalage[d];
+      joueur = caisse + niveau->decalage[d];
+      if (!vivante[caisse] && !niveau->mur[caisse] && !niveau->mur[joueur]) {
+        vivante[caisse] = VRAI;
+        file[fin++] = caisse;
+      }
+    }
+  }
+  memset(niveau->casesMortes, 0, sizeof(t_masque));
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (!niveau->mur[laCase] && !vivante[laCase]) {
+      masque_ajouter(niveau->casesMortes, laCase);
+    }
+  }
+}
+
+/**
+ * @brief Procédure qui repère les tunnels : cases d'un couloir de largeur 1,
+ * murs à gauche et à droite (couloir vertical) ou en haut et en bas (couloir
+ * horizontal).
+ * @param niveau t_niveau, murs remplis, tunnels en sortie
+ */
+void calculer_tunnels(t_niveau *niveau) {
+  int largeur = niveau->largeur;
+  memset(niveau->tunnels, 0, sizeof(niveau->tunnels));
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (niveau->mur[laCase]) {
+      continue;
+    }
+    if (niveau->mur[laCase - 1] && niveau->mur[laCase + 1]) {
+      masque_ajouter(niveau->tunnels[AXE_VERTICAL], laCase);
+    }
+    if (niveau->mur[laCase - largeur] && niveau->mur[laCase + largeur]) {
+      masque_ajouter(niveau->tunnels[AXE_HORIZONTAL], laCase);
+    }
+  }
+}
+
+/**
+ * @brief Procédure qui repère les salles des cibles : zones avec des cibles
+ * reliées au reste du niveau par une seule case (l'entrée), sans caisse ni
+ * joueur au départ. Les plus petites salles sont gardées, sans
+ * chevauchement, si un ordre de remplissage existe.
+ * @param plateau t_plateau, caisses et joueur au départ
+ * @param niveau t_niveau, murs, cibles et tunnels remplis, salles en sortie
+ */
+void calculer_salles(t_plateau *plateau, t_niveau *niveau) {
+  t_masque occupe = {0}, libre, zone, dejaVu, interdit = {0};
+  // une zone candidate par case au plus : sur le tas, trop grand pour la pile
+  t_masque *candidats = malloc((niveau->nbCases + 1) * sizeof(t_masque));
+  short entrees[MAX_CASES];
+  int tailles[MAX_CASES], nbCandidats = 0, voisine, autre, plusPetit;
+  bool valide;
+  char c;
+
+  if (candidats == NULL) {
+    printf("ERREUR MEMOIRE");
+    exit(EXIT_FAILURE);
+  }
+  niveau->nbSalles = 0;
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    c = plateau->cases[laCase];
+    if (est_caisse(c) || (c == JOUEUR)) {
+      masque_ajouter(occupe, laCase);
+    }
+  }
+  // 1. une zone candidate par entrée possible (la plus petite des zones
+  // séparées par cette case)
+  for (int entree = 0; entree < niveau->nbCases; entree++) {
+    if (niveau->mur[entree] || niveau->cible[entree] ||
+        masque_contient(occupe, entree)) {
+      continue;
+    }
+    for (int m = 0; m < niveau->nbMots; m++) {
+      libre[m] = ~niveau->murs[m];
+      dejaVu[m] = 0;
+    }
+    masque_retirer(libre, entree);
+    tailles[nbCandidats] = INT_MAX;
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      voisine = entree + niveau->decalage[d];
+      if (niveau->mur[voisine] || masque_contient(dejaVu, voisine)) {
+        continue;
+      }
+      memset(zone, 0, sizeof(t_masque));
+      masque_ajouter(zone, voisine);
+      inonder_masque(libre, zone, niveau->largeur, niveau->nbMots);
+      valide = FAUX;
+      for (int e = 0; e < NB_DIRECTIONS; e++) {
+        autre = entree + niveau->decalage[e];
+        valide = valide || (!niveau->mur[autre] && !masque_contient(zone, autre));
+      }
+      int taille = 0;
+      for (int m = 0; m < niveau->nbMots; m++) {
+        dejaVu[m] |= zone[m];
+        valide = valide && ((zone[m] & occupe[m]) == 0);
+        taille += __builtin_popcountll(zone[m]);
+      }
+      if (valide && masque_contient_un(zone, niveau->cibles, niveau->nbMots) &&
+          (taille < tailles[nbCandidats])) {
+        memcpy(candidats[nbCandidats], zone, sizeof(t_masque));
+        tailles[nbCandidats] = taille;
+        entrees[nbCandidats] = entree;
+      }
+    }
+    if (tailles[nbCandidats] != INT_MAX) {
+      nbCandidats++;
+    }
+  }
+  // 2. les plus petites salles d'abord, sans chevauchement
+  while ((nbCandidats > 0) && (niveau->nbSalles < MAX_SALLES)) {
+    plusPetit = 0;
+    for (int i = 1; i < nbCandidats; i++) {
+      if (tailles[i] < tailles[plusPetit]) {
+        plusPetit = i;
+      }
+    }
+    t_salle *salle = &niveau->salles[niveau->nbSalles];
+    salle->entree = entrees[plusPetit];
+    memcpy(salle->interieur, candidats[plusPetit], sizeof(t_masque));
+    nbCandidats--;
+    tailles[plusPetit] = tailles[nbCandidats];
+    entrees[plusPetit] = entrees[nbCandidats];
+    memcpy(candidats[plusPetit], candidats[nbCandidats], sizeof(t_masque));
+    if (masque_contient_un(salle->interieur, interdit, niveau->nbMots) ||
+        masque_contient(interdit, salle->entree) ||
+        !ordre_salle(niveau, salle)) {
+      continue;
+    }
+    for (int m = 0; m < niveau->nbMots; m++) {
+      interdit[m] |= salle->interieur[m];
+    }
+    masque_ajouter(interdit, salle->entree);
+    niveau->nbSalles += 1;
+  }
+  free(candidats);
+}
+
+/**
+ * @brief Fonction qui calcule l'ordre de remplissage d'une salle : la salle
+ * pleine, on cherche une caisse qui peut être amenée depuis l'entrée avec
+ * toutes les autres en place, c'est la dernière à ranger ; on recommence sans
+ * elle.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param salle t_salle, entrée et intérieur remplis, ordre en sortie
+ * @return FAUX si aucun ordre n'existe
+ */
+bool ordre_salle(const t_niveau *niveau, t_salle *salle) {
+  t_position position;
+  short cibles[MAX_CAISSES], chemin[MAX_CASES * NB_DIRECTIONS];
+  int nbCibles = 0, dehors = AUCUNE_CASE, voisine, t;
+  bool trouve = VRAI;
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (niveau->cible[laCase] && masque_contient(salle->interieur, laCase)) {
+      if (nbCibles == MAX_CAISSES) {
+        return FAUX;
+      }
+      cibles[nbCibles++] = laCase;
+    }
+  }
+  for (int d = 0; d < NB_DIRECTIONS; d++) {
+    voisine = salle->entree + niveau->decalage[d];
+    if (!niveau->mur[voisine] && !masque_contient(salle->interieur, voisine)) {
+      dehors = voisine;
+    }
+  }
+  salle->nbOrdre = nbCibles;
+  while ((nbCibles > 0) && trouve) {
+    trouve = FAUX;
+    for (t = 0; (t < nbCibles) && !trouve; t++) {
+      position_vide(niveau, &position);
+      for (int i = 0; i < nbCibles; i++) {
+        if (i != t) {
+          ajouter_caisse(&position, niveau, cibles[i]);
+        }
+      }
+      ajouter_caisse(&position, niveau, salle->entree);
+      position.joueur = dehors;
+      trouve = (chemin_caisse(&position, niveau, salle->entree, cibles[t],
+                              chemin) > 0);
+    }
+    if (trouve) {
+      // la dernière retirée est la première rangée
+      salle->ordre[nbCibles - 1] = cibles[t - 1];
+      cibles[t - 1] = cibles[nbCibles - 1];
+      nbCibles--;
+    }
+  }
+  return trouve;
+}
+
+/**
+ * @brief Fonction qui indique si deux masques ont une case en commun.
+ * @param a t_masque
+ * @param b t_masque
+ * @param nbMots int, mots utilisés par le niveau
+ */
+bool masque_contient_un(const t_masque a, const t_masque b, int nbMots) {
+  uint64_t commun = 0;
+  for (int m = 0; m < nbMots; m++) {
+    commun |= a[m] & b[m];
+  }
+  return commun != 0;
+}
+
+/**
+ * @brief Fonction qui indique si le bit d'une case est à 1 dans un masque.
+ * @param masque t_masque
+ * @param laCase int, numéro de la case
+ */
+bool masque_contient(const t_masque masque, int laCase) {
+  return (masque[laCase >> 6] >> (laCase & 63)) & 1;
+}
+
+/**
+ * @brief Procédure qui met à 1 le bit d'une case dans un masque.
+ * @param masque t_masque, en entrer et sortie
+ * @param laCase int, numéro de la case
+ */
+void masque_ajouter(t_masque masque, int laCase) {
+  masque[laCase >> 6] |= (uint64_t)1 << (laCase & 63);
+}
+
+/**
+ * @brief Procédure qui met à 0 le bit d'une case dans un masque.
+ * @param masque t_masque, en entrer et sortie
+ * @param laCase int, numéro de la case
+ */
+void masque_retirer(t_masque masque, int laCase) {
+  masque[laCase >> 6] &= ~((uint64_t)1 << (laCase & 63));
+}
+
+/**
+ * @brief Fonction qui donne la plus petite case dont le bit est à 1.
+ * @param masque t_masque
+ * @param nbMots int, mots utilisés par le niveau
+ * @return la case, AUCUNE_CASE si le masque est vide
+ */
+int masque_premiere_case(const t_masque masque, int nbMots) {
+  for (int m = 0; m < nbMots; m++) {
+    if (masque[m] != 0) {
+      return m * 64 + __builtin_ctzll(masque[m]);
+    }
+  }
+  return AUCUNE_CASE;
+}
+
+/**
+ * @brief Procédure qui étend une zone à toutes les cases libres qui lui sont
+ * reliées, par décalages de mots entiers : un mot gagne ses voisines des
+ * quatre directions (décalage de 1 bit pour gauche et droite, de largeur bits
+ * pour haut et bas) jusqu'à ne plus changer, sans sortir des registres, puis
+ * on passe au mot suivant avec les bits qui débordent de ses voisins. Le bord
+ * du plateau étant fait de murs, un décalage horizontal ne fait jamais passer
+ * d'une ligne à l'autre.
+ * @param libre t_masque, cases où la zone peut s'étendre
+ * @param zone t_masque, cases de départ, en entrer et sortie
+ * @param largeur int, largeur du plateau (moins de 64 cases)
+ * @param nbMots int, mots utilisés par le niveau, les suivants sont ignorés
+ */
+void inonder_masque(const t_masque libre, t_masque zone, int largeur,
+    int nbMots) {
+  uint64_t mot, precedent, entrant;
+  bool change = VRAI;
+  while (change) {
+    change = FAUX;
+    for (int m = 0; m < nbMots; m++) {
+      entrant = 0;
+      if (m > 0) {
+        entrant |= (zone[m - 1] >> 63) | (zone[m - 1] >> (64 - largeur));
+      }
+      if (m < nbMots - 1) {
+        entrant |= (zone[m + 1] << 63) | (zone[m + 1] << (64 - largeur));
+      }
+      mot = zone[m] | (entrant & libre[m]);
+      do {
+        precedent = mot;
+        mot = (mot | (mot << 1) | (mot >> 1) | (mot << largeur) |
+               (mot >> largeur)) &
+              libre[m];
+      } while (mot != precedent);
+      if (mot != zone[m]) {
+        zone[m] = mot;
+        change = VRAI;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Fonction qui tire la clé de Zobrist suivante (générateur splitmix64),
+ * la graine est fixe pour que les recherches soient reproductibles.
+ * @param graine uint64_t, état du générateur, en entrer et sortie
+ * @return une clé pseudo-aléatoire sur 64 bits
+ */
+uint64_t alea_zobrist(uint64_t *graine) {
+  uint64_t z = (*graine += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief Procédure qui construit la position de travail du solveur à partir
+ * d'un plateau de jeu.
+ * @param plateau t_plateau, caisses et joueur (couche mobile)
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, position de travail, en sortie
+ */
+void init_position(t_plateau *plateau, const t_niveau *niveau,
+    t_position *position) {
+  char c;
+  position->nbCaisses = 0;
+  position->joueur = AUCUNE_CASE;
+  position->cleCaisses = 0;
+  memset(position->bitsCaisses, 0, niveau->nbMots * sizeof(uint64_t));
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    c = plateau->cases[laCase];
+    position->cases[laCase] = niveau->mur[laCase] ? BORD : VIDE;
+    if (c == JOUEUR) {
+      position->joueur = laCase;
+    } else if (est_caisse(c) && (position->nbCaisses < MAX_CAISSES) &&
+               !niveau->mur[laCase]) {
+      position->caisses[position->nbCaisses] = laCase;
+      position->nbCaisses += 1;
+      position->cases[laCase] = CAISSE;
+      position->cleCaisses ^= niveau->zobristCaisse[laCase];
+      masque_ajouter(position->bitsCaisses, laCase);
+    }
+  }
+}
+
+/**
+ * @brief Fonction qui indique si un caractère du plateau est une caisse.
+ * @param c char, caractère du plateau
+ */
+bool est_caisse(char c) { return c == CAISSE; }
+
+/**
+ * @brief Fonction qui indique si une caisse ou le joueur peut aller sur une
+ * case, même règle que deplacer().
+ * @param c char, caractère du plateau
+ */
+bool est_libre(char c) { return c == VIDE; }
+
+/**
+ * @brief Procédure qui remplace les caisses de la position par celles d'un
+ * état mémorisé.
+ * @param position t_position, position de travail, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param caisses tableau des cases des caisses (triées)
+ * @param joueur int, case du joueur
+ */
+void placer_etat(t_position *position, const t_niveau *niveau,
+    const short caisses[], int joueur) {
+  int laCase;
+  for (int i = 0; i < position->nbCaisses; i++) {
+    laCase = position->caisses[i];
+    position->cases[laCase] = VIDE;
+  }
+  position->cleCaisses = 0;
+  memset(position->bitsCaisses, 0, niveau->nbMots * sizeof(uint64_t));
+  for (int i = 0; i < position->nbCaisses; i++) {
+    laCase = caisses[i];
+    position->caisses[i] = laCase;
+    position->cases[laCase] = CAISSE;
+    position->cleCaisses ^= niveau->zobristCaisse[laCase];
+    masque_ajouter(position->bitsCaisses, laCase);
+  }
+  position->joueur = joueur;
+}
+
+/**
+ * @brief Procédure qui pousse une caisse et garde la liste des caisses triée,
+ * le joueur prend la place de la caisse.
+ * @param position t_position, position de travail, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart int, case de la caisse avant la poussée
+ * @param arrivee int, case de la caisse après la poussée
+ */
+void pousser_caisse(t_position *position, const t_niveau *niveau, int depart,
+    int arrivee) {
+  int i = 0;
+  // les cibles sont dans le niveau : deux écritures, sans test
+  position->cases[depart] = VIDE;
+  position->cases[arrivee] = CAISSE;
+  // mise à jour incrémentale de la clé : la caisse quitte une case et arrive
+  // sur une autre
+  position->cleCaisses ^=
+      niveau->zobristCaisse[depart] ^ niveau->zobristCaisse[arrivee];
+  masque_retirer(position->bitsCaisses, depart);
+  masque_ajouter(position->bitsCaisses, arrivee);
+  while (position->caisses[i] != depart) {
+    i++;
+  }
+  // décalage pour garder les caisses triées
+  while ((i > 0) && (position->caisses[i - 1] > arrivee)) {
+    position->caisses[i] = position->caisses[i - 1];
+    i--;
+  }
+  while ((i < position->nbCaisses - 1) && (position->caisses[i + 1] < arrivee)) {
+    position->caisses[i] = position->caisses[i + 1];
+    i++;
+  }
+  position->caisses[i] = arrivee;
+  position->joueur = depart;
+}
+
+/**
+ * @brief Fonction qui calcule les cases atteignables par le joueur sans
+ * pousser de caisse (inondation en bits, voir inonder_masque()).
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param atteint t_masque, en sortie
+ * @return la plus petite case atteignable, qui sert à normaliser la position
+ * du joueur
+ */
+int acces_joueur(const t_position *position, const t_niveau *niveau,
+    t_masque atteint) {
+  t_masque libre;
+  int m = 0;
+  // un niveau analysé a toujours au moins un mot
+  do {
+    libre[m] = ~(niveau->murs[m] | position->bitsCaisses[m]);
+    atteint[m] = 0;
+  } while (++m < niveau->nbMots);
+  masque_ajouter(atteint, position->joueur);
+  inonder_masque(libre, atteint, niveau->largeur, niveau->nbMots);
+  return masque_premiere_case(atteint, niveau->nbMots);
+}
+
+/**
+ * @brief Fonction qui détecte un blocage par gel après la poussée d'une
+ * caisse : la caisse ne peut plus bouger ni verticalement ni horizontalement
+ * (murs, cases mortes des deux côtés ou autres caisses gelées) et le groupe
+ * gelé contient une caisse hors cible. Utilisable sur le plateau à plat du
+ * solveur comme sur celui du jeu (même numérotation des cases). Le coût est
+ * borné : au plus LIMITE_GEL caisses examinées, les caisses au-delà sont
+ * considérées comme mobiles (on ne signale jamais de faux blocage).
+ * @param cases tableau à plat des caractères du plateau
+ * @param niveau t_niveau, description fixe du niveau
+ * @param caisse int, case de la caisse qui vient d'être poussée
+ * @return VRAI si la position est perdue
+ */
+bool blocage_gel(const char cases[], const t_niveau *niveau, int caisse) {
+  short pile[LIMITE_GEL];
+  int nbPile = 0, budget = LIMITE_GEL;
+  bool horsCible = FAUX;
+  bool gelee =
+      caisse_gelee(cases, niveau, caisse, pile, &nbPile, &budget, &horsCible);
+  return gelee && horsCible;
+}
+
+/**
+ * @brief Fonction récursive qui indique si une caisse est gelée. Les caisses
+ * en cours d'examen (dans la pile) sont considérées comme des murs, ce qui
+ * évite les cycles.
+ * @param cases tableau à plat des caractères du plateau
+ * @param niveau t_niveau, description fixe du niveau
+ * @param caisse int, case de la caisse examinée
+ * @param pile tableau des caisses en cours d'examen, en entrer et sortie
+ * @param nbPile int, taille de la pile, en entrer et sortie
+ * @param budget int, nombre de caisses encore examinables, en entrer et sortie
+ * @param horsCible bool, mis à VRAI si une caisse gelée n'est pas sur une cible
+ * @return VRAI si la caisse est gelée
+ */
+bool caisse_gelee(const char cases[], const t_niveau *niveau, int caisse,
+    short pile[], int *nbPile, int *budget, bool *horsCible) {
+  bool gelee = FAUX;
+  bool horsCibleGroupe = !niveau->cible[caisse];
+  if (*budget <= 0) {
+    return FAUX;
+  }
+  *budget -= 1;
+  pile[(*nbPile)++] = caisse;
+  if (axe_bloque(cases, niveau, caisse, niveau->decalage[0], pile, nbPile,
+                 budget, &horsCibleGroupe) &&
+      axe_bloque(cases, niveau, caisse, niveau->decalage[2], pile, nbPile,
+                 budget, &horsCibleGroupe)) {
+    gelee = VRAI;
+  }
+  *nbPile -= 1;
+  // les caisses vues ne comptent que si cette caisse est vraiment gelée
+  if (gelee && horsCibleGroupe) {
+    *horsCible = VRAI;
+  }
+  return gelee;
+}
+
+/**
+ * @brief Fonction qui indique si une caisse ne peut pas bouger sur un axe.
+ * @param cases tableau à plat des caractères du plateau
+ * @param niveau t_niveau, description fixe du niveau
+ * @param caisse int, case de la caisse examinée
+ * @param decalage int, décalage d'une case sur l'axe (vertical ou horizontal)
+ * @param pile tableau des caisses en cours d'examen
+ * @param nbPile int, taille de la pile
+ * @param budget int, nombre de caisses encore examinables
+ * @param horsCible bool, en entrer et sortie
+ * @return VRAI si l'axe est bloqué
+ */
+bool axe_bloque(const char cases[], const t_niveau *niveau, int caisse,
+    int decalage, short pile[], int *nbPile, int *budget, bool *horsCible) {
+  int avant = caisse - decalage, apres = caisse + decalage;
+  bool murAvant = niveau->mur[avant], murApres = niveau->mur[apres];
+  for (int i = 0; i < *nbPile; i++) {
+    murAvant = murAvant || (pile[i] == avant);
+    murApres = murApres || (pile[i] == apres);
+  }
+  if (murAvant || murApres) {
+    return VRAI;
+  }
+  if (masque_contient(niveau->casesMortes, avant) &&
+      masque_contient(niveau->casesMortes, apres)) {
+    return VRAI;
+  }
+  return (est_caisse(cases[avant]) &&
+          caisse_gelee(cases, niveau, avant, pile, nbPile, budget,
+                       horsCible)) ||
+         (est_caisse(cases[apres]) &&
+          caisse_gelee(cases, niveau, apres, pile, nbPile, budget, horsCible));
+}
+
+/**
+ * @brief Fonction qui cherche un PI-corral : une zone que le joueur ne peut
+ * pas atteindre, fermée par des caisses (la clôture), telle que toute poussée
+ * possible d'une caisse de la clôture va dans la zone (I) et que le joueur
+ * peut déjà faire toutes ces poussées (P). Il faudra de toute façon pousser
+ * une caisse de la clôture vers l'intérieur, on peut donc se limiter à ces
+ * poussées. Les zones déjà résolues (caisses sur cibles, pas de cible vide)
+ * sont ignorées.
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param atteint tableau des cases atteignables par le joueur
+ * @param cloture t_masque, caisses de la clôture du plus petit PI-corral, en
+ * sortie
+ * @return VRAI si un PI-corral a été trouvé (poussées à restreindre)
+ */
+bool corral_pi(const t_position *position, const t_niveau *niveau,
+    const t_masque atteint, t_masque cloture) {
+  int region[MAX_CASES], parent[MAX_CASES], file[MAX_CASES];
+  int corralCaisse[MAX_CAISSES];
+  bool cibleVide[MAX_CASES], valide[MAX_CASES];
+  int nbRegions = 0, debut, fin, laCase, voisine, r, caisse, devant, derriere;
+  int meilleur = AUCUNE_CASE, tailleMeilleur = MAX_CAISSES + 1, taille;
+  uint64_t horsAtteinte = 0;
+
+  // cas le plus fréquent : le joueur atteint toutes les cases libres
+  for (int m = 0; m < niveau->nbMots; m++) {
+    horsAtteinte |=
+        ~(niveau->murs[m] | position->bitsCaisses[m] | atteint[m]);
+  }
+  if (horsAtteinte == 0) {
+    return FAUX;
+  }
+  // 1. zones non atteintes séparées par les murs et les caisses
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    region[laCase] = AUCUNE_CASE;
+  }
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if ((region[laCase] != AUCUNE_CASE) || masque_contient(atteint, laCase) ||
+        !est_libre(position->cases[laCase])) {
+      continue;
+    }
+    parent[nbRegions] = nbRegions;
+    cibleVide[nbRegions] = FAUX;
+    valide[nbRegions] = VRAI;
+    region[laCase] = nbRegions;
+    debut = 0;
+    fin = 0;
+    file[fin++] = laCase;
+    while (debut < fin) {
+      voisine = file[debut++];
+      cibleVide[nbRegions] = cibleVide[nbRegions] || niveau->cible[voisine];
+      for (int d = 0; d < NB_DIRECTIONS; d++) {
+        int v = voisine + niveau->decalage[d];
+        if ((region[v] == AUCUNE_CASE) && est_libre(position->cases[v])) {
+          region[v] = nbRegions;
+          file[fin++] = v;
+        }
+      }
+    }
+    nbRegions++;
+  }
+  if (nbRegions == 0) {
+    return FAUX;
+  }
+  // 2. les zones qui touchent la même caisse forment un seul corral
+  for (int i = 0; i < position->nbCaisses; i++) {
+    caisse = position->caisses[i];
+    corralCaisse[i] = AUCUNE_CASE;
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      voisine = caisse + niveau->decalage[d];
+      if (region[voisine] == AUCUNE_CASE) {
+        continue;
+      }
+      r = racine_region(parent, region[voisine]);
+      if (corralCaisse[i] == AUCUNE_CASE) {
+        corralCaisse[i] = r;
+      } else if (r != corralCaisse[i]) {
+        parent[r] = corralCaisse[i];
+        cibleVide[corralCaisse[i]] = cibleVide[corralCaisse[i]] || cibleVide[r];
+      }
+    }
+  }
+  for (int i = 0; i < position->nbCaisses; i++) {
+    if (corralCaisse[i] != AUCUNE_CASE) {
+      corralCaisse[i] = racine_region(parent, corralCaisse[i]);
+    }
+  }
+  for (r = 0; r < nbRegions; r++) {
+    if (parent[r] != r) {
+      int racine = racine_region(parent, r);
+      cibleVide[racine] = cibleVide[racine] || cibleVide[r];
+    }
+  }
+  // 3. conditions I et P sur chaque caisse de la clôture
+  for (int i = 0; i < position->nbCaisses; i++) {
+    r = corralCaisse[i];
+    if (r == AUCUNE_CASE) {
+      continue;
+    }
+    caisse = position->caisses[i];
+    if (!niveau->cible[caisse]) {
+      cibleVide[r] = VRAI; // le corral n'est pas résolu
+    }
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      derriere = caisse - niveau->decalage[d];
+      devant = caisse + niveau->decalage[d];
+      if ((region[devant] != AUCUNE_CASE) &&
+          (racine_region(parent, region[devant]) == r)) {
+        // poussée vers l'intérieur : le joueur doit pouvoir la faire (P)
+        if (!masque_contient(atteint, derriere) && !niveau->mur[derriere]) {
+          valide[r] = FAUX;
+        }
+      } else if (masque_contient(atteint, derriere) && !niveau->mur[devant]) {
+        // poussée possible (maintenant ou plus tard) vers l'extérieur (I)
+        valide[r] = FAUX;
+      }
+    }
+  }
+  // 4. choix du PI-corral avec la plus petite clôture
+  for (r = 0; r < nbRegions; r++) {
+    if ((parent[r] != r) || !valide[r] || !cibleVide[r]) {
+      continue;
+    }
+    taille = 0;
+    for (int i = 0; i < position->nbCaisses; i++) {
+      taille += (corralCaisse[i] == r);
+    }
+    if ((taille > 0) && (taille < tailleMeilleur)) {
+      meilleur = r;
+      tailleMeilleur = taille;
+    }
+  }
+  if (meilleur == AUCUNE_CASE) {
+    return FAUX;
+  }
+  memset(cloture, 0, sizeof(t_masque));
+  for (int i = 0; i < position->nbCaisses; i++) {
+    if (corralCaisse[i] == meilleur) {
+      masque_ajouter(cloture, position->caisses[i]);
+    }
+  }
+  return VRAI;
+}
+
+/**
+ * @brief Fonction qui donne la région représentante d'un corral (union des
+ * zones), avec compression du chemin.
+ * @param parent tableau des parents des régions, en entrer et sortie
+ * @param region int, numéro de la région
+ */
+int racine_region(int parent[], int region) {
+  while (parent[region] != region) {
+    parent[region] = parent[parent[region]];
+    region = parent[region];
+  }
+  return region;
+}
+
+/**
+ * @brief Fonction qui indique si toutes les cibles ont une caisse, même règle
+ * que gagne().
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ */
+bool position_gagnante(const t_position *position, const t_niveau *niveau) {
+  uint64_t manque = 0;
+  for (int m = 0; m < niveau->nbMots; m++) {
+    manque |= niveau->cibles[m] & ~position->bitsCaisses[m];
+  }
+  return manque == 0;
+}
+
+/**
+ * @brief Fonction qui alloue la mémoire du solveur. La table de transposition
+ * est dimensionnée pour que la table et les noeuds tiennent dans la mémoire
+ * autorisée, avec un taux de remplissage maximal de 3/4.
+ * @param solveur t_solveur, en sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param nbCaisses int, nombre de caisses du niveau
+ * @param memoireMo long, mémoire maximale en Mo
+ * @return VRAI si l'allocation a réussi
+ */
+bool init_solveur(t_solveur *solveur, const t_niveau *niveau, int nbCaisses,
+    long memoireMo) {
+  size_t memoire = (size_t)memoireMo * 1024 * 1024;
+  size_t octetsNoeud = sizeof(t_noeud) + nbCaisses * sizeof(short);
+  size_t octetsAlveole = sizeof(uint64_t) + sizeof(int);
+  size_t taille = 1024;
+  if (&solveur->niveau != niveau) {
+    solveur->niveau = *niveau;
+  }
+  while ((taille * 2 * octetsAlveole + taille * 2 / 4 * 3 * octetsNoeud <=
+          memoire) &&
+         (taille * 2 / 4 * 3 < INT_MAX)) {
+    taille *= 2;
+  }
+  solveur->nbCaisses = nbCaisses;
+  solveur->nbNoeuds = 0;
+  solveur->maxNoeuds = taille / 4 * 3;
+  solveur->capacite = (CAPACITE_INITIALE < solveur->maxNoeuds)
+                          ? CAPACITE_INITIALE
+                          : solveur->maxNoeuds;
+  solveur->noeudsDeveloppes = 0;
+  solveur->memoirePleine = FAUX;
+  solveur->macros = FAUX;
+  solveur->arret = NULL;
+  solveur->echeance = 0;
+  solveur->horsDelai = FAUX;
+  solveur->noeuds = malloc(solveur->capacite * sizeof(t_noeud));
+  solveur->caisses =
+      malloc((size_t)solveur->capacite * nbCaisses * sizeof(short));
+  if (!init_table(&solveur->table, taille) || (solveur->noeuds == NULL) ||
+      (solveur->caisses == NULL)) {
+    liberer_solveur(solveur);
+    return FAUX;
+  }
+  return VRAI;
+}
+
+/**
+ * @brief Procédure qui libère la mémoire du solveur.
+ * @param solveur t_solveur
+ */
+void liberer_solveur(t_solveur *solveur) {
+  free(solveur->noeuds);
+  free(solveur->caisses);
+  liberer_table(&solveur->table);
+  solveur->noeuds = NULL;
+  solveur->caisses = NULL;
+}
+
+/**
+ * @brief Fonction qui alloue une table de transposition vide.
+ * @param table t_table, en sortie
+ * @param taille size_t, nombre d'alvéoles (puissance de 2)
+ * @return VRAI si l'allocation a réussi
+ */
+bool init_table(t_table *table, size_t taille) {
+  table->taille = taille;
+  table->nbEntrees = 0;
+  table->cles = calloc(taille, sizeof(uint64_t));
+  table->valeurs = malloc(taille * sizeof(int));
+  return (table->cles != NULL) && (table->valeurs != NULL);
+}
+
+/**
+ * @brief Procédure qui libère une table de transposition.
+ * @param table t_table
+ */
+void liberer_table(t_table *table) {
+  free(table->cles);
+  free(table->valeurs);
+  table->cles = NULL;
+  table->valeurs = NULL;
+}
+
+/**
+ * @brief Fonction qui donne la clé de Zobrist d'une position : clés des caisses
+ * (tenues à jour à chaque poussée) et clé de la case normalisée du joueur.
+ * @param position t_position, position avec le joueur normalisé
+ * @param niveau t_niveau, description fixe du niveau
+ * @return la clé, jamais nulle car 0 marque une alvéole vide
+ */
+uint64_t cle_position(const t_position *position, const t_niveau *niveau) {
+  uint64_t cle = position->cleCaisses ^ niveau->zobristJoueur[position->joueur];
+  return (cle == 0) ? 1 : cle;
+}
+
+/**
+ * @brief Fonction qui ajoute la position courante aux noeuds de la recherche
+ * si elle n'est pas déjà dans la table de transposition (sondage linéaire).
+ * @param solveur t_solveur
+ * @param position t_position, position avec le joueur normalisé
+ * @param parent int, indice du noeud parent
+ * @param depart int, case de la caisse avant la poussée
+ * @param arrivee int, case de la caisse après la poussée
+ * @param nouveau bool, VRAI si le noeud vient d'être créé, en sortie
+ * @return l'indice du noeud, AUCUNE_CASE si la mémoire est pleine
+ */
+int ajouter_noeud(t_solveur *solveur, const t_position *position, int parent,
+    int depart, int arrivee, bool *nouveau) {
+  int k = solveur->nbCaisses, i;
+  t_table *table = &solveur->table;
+  uint64_t cle = cle_position(position, &solveur->niveau);
+  size_t alveole = cle & (table->taille - 1);
+  *nouveau = FAUX;
+  while (table->cles[alveole] != 0) {
+    // la clé suffit presque toujours, la comparaison écarte les collisions
+    i = table->valeurs[alveole];
+    if ((table->cles[alveole] == cle) &&
+        (solveur->noeuds[i].joueur == position->joueur) &&
+        (memcmp(&solveur->caisses[(size_t)i * k], position->caisses,
+                k * sizeof(short)) == 0)) {
+      return i;
+    }
+    alveole = (alveole + 1) & (table->taille - 1);
+  }
+  if (solveur->nbNoeuds == solveur->maxNoeuds) {
+    return AUCUNE_CASE;
+  }
+  if ((solveur->nbNoeuds == solveur->capacite) &&
+      !agrandir_noeuds(solveur, (solveur->capacite <= solveur->maxNoeuds / 2)
+                                    ? solveur->capacite * 2
+                                    : solveur->maxNoeuds)) {
+    return AUCUNE_CASE;
+  }
+  i = solveur->nbNoeuds;
+  solveur->nbNoeuds += 1;
+  solveur->noeuds[i].parent = parent;
+  solveur->noeuds[i].depart = depart;
+  solveur->noeuds[i].arrivee = arrivee;
+  solveur->noeuds[i].joueur = position->joueur;
+  solveur->noeuds[i].poussees =
+      (parent == AUCUNE_CASE) ? 0 : solveur->noeuds[parent].poussees + 1;
+  memcpy(&solveur->caisses[(size_t)i * k], position->caisses,
+         k * sizeof(short));
+  table->cles[alveole] = cle;
+  table->valeurs[alveole] = i;
+  table->nbEntrees += 1;
+  *nouveau = VRAI;
+  return i;
+}
+
+/**
+ * @brief Fonction qui liste les poussées à développer depuis une position :
+ * le joueur atteint l'arrière de la caisse, la case devant est libre et n'est
+ * pas morte. S'il existe un PI-corral seules les caisses de sa clôture sont
+ * gardées.
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param atteint tableau des cases atteignables par le joueur
+ * @param poussees tableau des poussées, en sortie
+ * @return le nombre de poussées
+ */
+int lister_poussees(const t_position *position, const t_niveau *niveau,
+    const t_masque atteint, t_poussee poussees[]) {
+  t_masque cloture;
+  bool restreint = corral_pi(position, niveau, atteint, cloture);
+  int nb = 0, caisse, devant;
+  for (int i = 0; i < position->nbCaisses; i++) {
+    caisse = position->caisses[i];
+    if (restreint && !masque_contient(cloture, caisse)) {
+      continue;
+    }
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      devant = caisse + niveau->decalage[d];
+      if (masque_contient(atteint, caisse - niveau->decalage[d]) &&
+          est_libre(position->cases[devant]) &&
+          !masque_contient(niveau->casesMortes, devant)) {
+        poussees[nb].depart = caisse;
+        poussees[nb].arrivee = devant;
+        poussees[nb].joueur = caisse;
+        poussees[nb].cout = 1;
+        nb++;
+      }
+    }
+  }
+  return nb;
+}
+
+/**
+ * @brief Fonction qui joue une poussée sur la position de travail et l'annule
+ * tout de suite si elle gèle une caisse hors cible.
+ * @param position t_position, position de travail, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param poussee t_poussee, la poussée
+ * @return VRAI si la poussée a été jouée
+ */
+bool jouer_poussee(t_position *position, const t_niveau *niveau,
+    t_poussee poussee) {
+  pousser_caisse(position, niveau, poussee.depart, poussee.arrivee);
+  position->joueur = poussee.joueur;
+  if (blocage_gel(position->cases, niveau, poussee.arrivee)) {
+    pousser_caisse(position, niveau, poussee.arrivee, poussee.depart);
+    return FAUX;
+  }
+  return VRAI;
+}
+
+/**
+ * @brief Procédure qui annule une poussée jouée avec jouer_poussee(). Pour un
+ * macro-coup la case du joueur est à remettre par l'appelant.
+ * @param position t_position, position de travail, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param poussee t_poussee, la poussée
+ */
+void annuler_poussee(t_position *position, const t_niveau *niveau,
+    t_poussee poussee) {
+  pousser_caisse(position, niveau, poussee.arrivee, poussee.depart);
+  position->joueur = poussee.depart - (poussee.arrivee - poussee.depart);
+}
+
+/**
+ * @brief Procédure qui prépare une position sans caisse ni joueur.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, en sortie
+ */
+void position_vide(const t_niveau *niveau, t_position *position) {
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    position->cases[laCase] = niveau->mur[laCase] ? BORD : VIDE;
+  }
+  position->nbCaisses = 0;
+  position->joueur = AUCUNE_CASE;
+  position->cleCaisses = 0;
+  memset(position->bitsCaisses, 0, niveau->nbMots * sizeof(uint64_t));
+}
+
+/**
+ * @brief Procédure qui ajoute une caisse à une position en gardant la liste
+ * des caisses triée.
+ * @param position t_position, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param laCase int, case de la caisse
+ */
+void ajouter_caisse(t_position *position, const t_niveau *niveau,
+    int laCase) {
+  int i = position->nbCaisses;
+  while ((i > 0) && (position->caisses[i - 1] > laCase)) {
+    position->caisses[i] = position->caisses[i - 1];
+    i--;
+  }
+  position->caisses[i] = laCase;
+  position->nbCaisses += 1;
+  position->cases[laCase] = CAISSE;
+  position->cleCaisses ^= niveau->zobristCaisse[laCase];
+  masque_ajouter(position->bitsCaisses, laCase);
+}
+
+/**
+ * @brief Fonction qui cherche le plus court chemin en poussées d'une seule
+ * caisse, les autres restant en place : parcours en largeur sur les couples
+ * (case de la caisse, côté du joueur). La position est rendue inchangée.
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart int, case de départ de la caisse
+ * @param arrivee int, case d'arrivée de la caisse
+ * @param chemin tableau des cases de la caisse, départ et arrivée compris, en
+ * sortie
+ * @return le nombre de cases du chemin, 0 s'il n'existe pas
+ */
+int chemin_caisse(t_position *position, const t_niveau *niveau, int depart,
+    int arrivee, short chemin[]) {
+  short parent[MAX_CASES * NB_DIRECTIONS];
+  short file[MAX_CASES * NB_DIRECTIONS];
+  bool vu[MAX_CASES * NB_DIRECTIONS] = {FAUX};
+  t_masque atteint;
+  int joueur = position->joueur, ici = depart, debut = 0, fin = 0;
+  int etat, caisse, suivant, trouve = AUCUNE_CASE, nb = 0;
+
+  acces_joueur(position, niveau, atteint);
+  for (int d = 0; d < NB_DIRECTIONS; d++) {
+    if (masque_contient(atteint, depart - niveau->decalage[d])) {
+      etat = depart * NB_DIRECTIONS + d;
+      vu[etat] = VRAI;
+      parent[etat] = AUCUNE_CASE;
+      file[fin++] = etat;
+    }
+  }
+  while ((debut < fin) && (trouve == AUCUNE_CASE)) {
+    etat = file[debut++];
+    caisse = etat / NB_DIRECTIONS;
+    if (caisse == arrivee) {
+      trouve = etat;
+      continue;
+    }
+    if (caisse != ici) {
+      pousser_caisse(position, niveau, ici, caisse);
+      ici = caisse;
+    }
+    position->joueur = caisse - niveau->decalage[etat % NB_DIRECTIONS];
+    acces_joueur(position, niveau, atteint);
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      suivant = caisse + niveau->decalage[d];
+      if (masque_contient(atteint, caisse - niveau->decalage[d]) &&
+          est_libre(position->cases[suivant]) &&
+          !vu[suivant * NB_DIRECTIONS + d]) {
+        vu[suivant * NB_DIRECTIONS + d] = VRAI;
+        parent[suivant * NB_DIRECTIONS + d] = etat;
+        file[fin++] = suivant * NB_DIRECTIONS + d;
+      }
+    }
+  }
+  if (ici != depart) {
+    pousser_caisse(position, niveau, ici, depart);
+  }
+  position->joueur = joueur;
+  if (trouve == AUCUNE_CASE) {
+    return 0;
+  }
+  for (etat = trouve; etat != AUCUNE_CASE; etat = parent[etat]) {
+    nb++;
+  }
+  for (int i = nb - 1, e = trouve; i >= 0; i--, e = parent[e]) {
+    chemin[i] = e / NB_DIRECTIONS;
+  }
+  return nb;
+}
+
+/**
+ * @brief Procédure qui remplace des poussées par des macro-coups : une caisse
+ * poussée dans un tunnel (le joueur derrière elle aussi dans le tunnel) est
+ * poussée jusqu'au bout, une caisse poussée sur l'entrée d'une salle des
+ * cibles est rangée directement sur la cible suivante de l'ordre de
+ * remplissage.
+ * @param position t_position, position de travail (rendue inchangée)
+ * @param niveau t_niveau, description fixe du niveau
+ * @param poussees tableau des poussées, en entrer et sortie
+ * @param nbPoussees int, nombre de poussées
+ */
+void etendre_macros(t_position *position, const t_niveau *niveau,
+    t_poussee poussees[], int nbPoussees) {
+  for (int p = 0; p < nbPoussees; p++) {
+    etendre_tunnel(position, niveau, &poussees[p]);
+    for (int s = 0; s < niveau->nbSalles; s++) {
+      if ((poussees[p].arrivee == niveau->salles[s].entree) &&
+          !masque_contient(niveau->salles[s].interieur, poussees[p].depart)) {
+        entrer_salle(position, niveau, &niveau->salles[s], &poussees[p]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Procédure qui prolonge une poussée dans un tunnel tant que la caisse
+ * n'est pas sur une cible et que la case suivante est libre et pas morte.
+ * @param position t_position, position avant la poussée
+ * @param niveau t_niveau, description fixe du niveau
+ * @param poussee t_poussee, en entrer et sortie
+ */
+void etendre_tunnel(const t_position *position, const t_niveau *niveau,
+    t_poussee *poussee) {
+  int decalage = poussee->arrivee - poussee->depart;
+  int axe = ((decalage == 1) || (decalage == -1)) ? AXE_HORIZONTAL
+                                                  : AXE_VERTICAL;
+  int joueur = poussee->depart, caisse = poussee->arrivee;
+  while (!niveau->cible[caisse] &&
+         masque_contient(niveau->tunnels[axe], caisse) &&
+         masque_contient(niveau->tunnels[axe], joueur) &&
+         est_libre(position->cases[caisse + decalage]) &&
+         !masque_contient(niveau->casesMortes, caisse + decalage)) {
+    joueur = caisse;
+    caisse += decalage;
+  }
+  poussee->arrivee = caisse;
+  poussee->joueur = joueur;
+  poussee->cout = (caisse - poussee->depart) / decalage;
+}
+
+/**
+ * @brief Procédure qui change une poussée sur l'entrée d'une salle en
+ * macro-coup jusqu'à la cible suivante de l'ordre de remplissage, si les
+ * caisses déjà dans la salle sont sur les premières cibles de l'ordre.
+ * @param position t_position, position avant la poussée
+ * @param niveau t_niveau, description fixe du niveau
+ * @param salle t_salle, la salle
+ * @param poussee t_poussee, en entrer et sortie
+ */
+void entrer_salle(t_position *position, const t_niveau *niveau,
+    const t_salle *salle, t_poussee *poussee) {
+  short chemin[MAX_CASES * NB_DIRECTIONS];
+  int dedans = 0, nb;
+  for (int m = 0; m < niveau->nbMots; m++) {
+    dedans += __builtin_popcountll(position->bitsCaisses[m] &
+                                   salle->interieur[m]);
+  }
+  if (dedans >= salle->nbOrdre) {
+    return;
+  }
+  for (int i = 0; i < dedans; i++) {
+    if (!masque_contient(position->bitsCaisses, salle->ordre[i])) {
+      return;
+    }
+  }
+  nb = chemin_caisse(position, niveau, poussee->depart, salle->ordre[dedans],
+                     chemin);
+  if (nb >= 2) {
+    poussee->arrivee = salle->ordre[dedans];
+    poussee->joueur = chemin[nb - 2];
+    poussee->cout = nb - 1;
+  }
+}
+
+/**
+ * @brief Fonction qui remplace les macro-coups d'une solution par des
+ * poussées d'une case, en cherchant de nouveau le chemin de la caisse. Les
+ * poussées d'une case sont gardées telles quelles : une solution sans
+ * macro-coup (--optimise) n'est pas limitée à TAILLE_DEPLACEMENT poussées.
+ * @param plateau t_plateau, plateau de jeu à la position de départ
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart tableau des cases de départ des caisses, en entrer et sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en entrer et sortie
+ * @param nbCoups int, nombre de coups
+ * @return le nombre de poussées, AUCUNE_CASE si la solution est trop longue
+ */
+int developper_macros(t_plateau *plateau, const t_niveau *niveau,
+    short depart[], short arrivee[], int nbCoups) {
+  t_position position;
+  short chemin[MAX_CASES * NB_DIRECTIONS];
+  short departs[TAILLE_DEPLACEMENT], arrivees[TAILLE_DEPLACEMENT];
+  int nb = 0, nbChemin;
+  while ((nb < nbCoups) && poussee_simple(niveau, depart[nb], arrivee[nb])) {
+    nb++;
+  }
+  if (nb == nbCoups) {
+    return nbCoups; // rien à développer
+  }
+  nb = 0;
+  init_position(plateau, niveau, &position);
+  for (int c = 0; c < nbCoups; c++) {
+    if (poussee_simple(niveau, depart[c], arrivee[c])) {
+      chemin[0] = depart[c];
+      chemin[1] = arrivee[c];
+      nbChemin = 2;
+    } else {
+      nbChemin = chemin_caisse(&position, niveau, depart[c], arrivee[c],
+                               chemin);
+    }
+    if ((nbChemin < 2) || (nb + nbChemin - 1 > TAILLE_DEPLACEMENT)) {
+      return AUCUNE_CASE;
+    }
+    for (int i = 0; i + 1 < nbChemin; i++) {
+      departs[nb] = chemin[i];
+      arrivees[nb] = chemin[i + 1];
+      nb++;
+    }
+    pousser_caisse(&position, niveau, depart[c], arrivee[c]);
+    position.joueur = chemin[nbChemin - 2];
+  }
+  memcpy(depart, departs, nb * sizeof(short));
+  memcpy(arrivee, arrivees, nb * sizeof(short));
+  return nb;
+}
+
+/**
+ * @brief Fonction qui indique si une poussée déplace la caisse d'une seule
+ * case.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart int, case de départ de la caisse
+ * @param arrivee int, case d'arrivée de la caisse
+ */
+bool poussee_simple(const t_niveau *niveau, int depart, int arrivee) {
+  bool simple = FAUX;
+  for (int d = 0; d < NB_DIRECTIONS; d++) {
+    simple = simple || (arrivee - depart == niveau->decalage[d]);
+  }
+  return simple;
+}
+
+/**
+ * @brief Procédure qui calcule, pour chaque cible, le nombre minimal de
+ * poussées pour y amener une caisse seule depuis chaque case (tirages depuis
+ * la cible, comme pour les cases mortes).
+ * @param niveau t_niveau, murs et cibles remplis, distances en sortie
+ */
+void calculer_distances(t_niveau *niveau) {
+  int file[MAX_CASES];
+  int debut, fin, laCase, caisse, joueur, c;
+  short *distance;
+  niveau->nbListeCibles = 0;
+  for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (niveau->cible[laCase] && (niveau->nbListeCibles < MAX_CAISSES)) {
+      niveau->listeCibles[niveau->nbListeCibles++] = laCase;
+    }
+  }
+  for (c = 0; c < niveau->nbListeCibles; c++) {
+    distance = &niveau->distanceCible[c * niveau->nbCases];
+    for (laCase = 0; laCase < niveau->nbCases; laCase++) {
+      distance[laCase] = INFINI_DISTANCE;
+    }
+    debut = 0;
+    fin = 0;
+    distance[niveau->listeCibles[c]] = 0;
+    file[fin++] = niveau->listeCibles[c];
+    while (debut < fin) {
+      laCase = file[debut++];
+      for (int d = 0; d < NB_DIRECTIONS; d++) {
+        caisse = laCase + niveau->decalage[d];
+        joueur = caisse + niveau->decalage[d];
+        if ((distance[caisse] == INFINI_DISTANCE) && !niveau->mur[caisse] &&
+            !niveau->mur[joueur]) {
+          distance[caisse] = distance[laCase] + 1;
+          file[fin++] = caisse;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Fonction qui donne le coût d'affecter la caisse d'une ligne à une
+ * cible (colonne). Les colonnes au-delà des cibles sont des cibles fictives
+ * de coût nul pour les caisses en trop.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param appariement t_appariement
+ * @param ligne int, ligne de la caisse (à partir de 1)
+ * @param colonne int, colonne de la cible (à partir de 1)
+ */
+int cout_appariement(const t_niveau *niveau, const t_appariement *appariement,
+    int ligne, int colonne) {
+  int cout = 0;
+  if (colonne <= niveau->nbListeCibles) {
+    cout = niveau->distanceCible[(colonne - 1) * niveau->nbCases +
+                                 appariement->caseLigne[ligne]];
+  }
+  return cout;
+}
+
+/**
+ * @brief Procédure qui calcule entièrement l'affectation de coût minimal des
+ * caisses aux cibles (méthode hongroise avec potentiels).
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, position de travail
+ * @param appariement t_appariement, en sortie
+ */
+void calculer_appariement(const t_niveau *niveau, const t_position *position,
+    t_appariement *appariement) {
+  appariement->n = position->nbCaisses;
+  for (int j = 0; j <= appariement->n; j++) {
+    appariement->u[j] = 0;
+    appariement->v[j] = 0;
+    appariement->ligneColonne[j] = 0;
+  }
+  for (int i = 1; i <= appariement->n; i++) {
+    appariement->caseLigne[i] = position->caisses[i - 1];
+  }
+  for (int i = 1; i <= appariement->n; i++) {
+    augmenter_ligne(niveau, appariement, i);
+  }
+}
+
+/**
+ * @brief Procédure qui affecte une ligne libre par un plus court chemin
+ * augmentant, en gardant des potentiels compatibles (u[i] + v[j] <= coût).
+ * Coût en O(n²).
+ * @param niveau t_niveau, description fixe du niveau
+ * @param appariement t_appariement, en entrer et sortie
+ * @param ligne int, ligne à affecter
+ */
+void augmenter_ligne(const t_niveau *niveau, t_appariement *appariement,
+    int ligne) {
+  int n = appariement->n;
+  int minv[MAX_CAISSES + 1], chemin[MAX_CAISSES + 1];
+  bool utilise[MAX_CAISSES + 1];
+  int *p = appariement->ligneColonne, *u = appariement->u, *v = appariement->v;
+  int j0 = 0, j1 = 0, i0, delta, cout;
+  for (int j = 0; j <= n; j++) {
+    minv[j] = INT_MAX;
+    utilise[j] = FAUX;
+  }
+  p[0] = ligne;
+  do {
+    utilise[j0] = VRAI;
+    i0 = p[j0];
+    delta = INT_MAX;
+    for (int j = 1; j <= n; j++) {
+      if (!utilise[j]) {
+        cout = cout_appariement(niveau, appariement, i0, j) - u[i0] - v[j];
+        if (cout < minv[j]) {
+          minv[j] = cout;
+          chemin[j] = j0;
+        }
+        if (minv[j] < delta) {
+          delta = minv[j];
+          j1 = j;
+        }
+      }
+    }
+    for (int j = 0; j <= n; j++) {
+      if (utilise[j]) {
+        u[p[j]] += delta;
+        v[j] -= delta;
+      } else {
+        minv[j] -= delta;
+      }
+    }
+    j0 = j1;
+  } while (p[j0] != 0);
+  // inversion du chemin augmentant
+  do {
+    j1 = chemin[j0];
+    p[j0] = p[j1];
+    j0 = j1;
+  } while (j0 != 0);
+}
+
+/**
+ * @brief Procédure qui met à jour l'affectation quand une seule caisse a
+ * bougé : sa ligne est libérée, son potentiel recalculé puis elle est
+ * réaffectée par un seul chemin augmentant (O(n²) au lieu de O(n³)).
+ * @param niveau t_niveau, description fixe du niveau
+ * @param appariement t_appariement, en entrer et sortie
+ * @param depart int, ancienne case de la caisse
+ * @param arrivee int, nouvelle case de la caisse
+ */
+void deplacer_appariement(const t_niveau *niveau, t_appariement *appariement,
+    int depart, int arrivee) {
+  int ligne = 1, cout;
+  while (appariement->caseLigne[ligne] != depart) {
+    ligne++;
+  }
+  appariement->caseLigne[ligne] = arrivee;
+  for (int j = 1; j <= appariement->n; j++) {
+    if (appariement->ligneColonne[j] == ligne) {
+      appariement->ligneColonne[j] = 0;
+    }
+  }
+  appariement->u[ligne] = INT_MAX;
+  for (int j = 1; j <= appariement->n; j++) {
+    cout = cout_appariement(niveau, appariement, ligne, j) - appariement->v[j];
+    if (cout < appariement->u[ligne]) {
+      appariement->u[ligne] = cout;
+    }
+  }
+  augmenter_ligne(niveau, appariement, ligne);
+}
+
+/**
+ * @brief Fonction qui donne le coût de l'affectation : minorant du nombre de
+ * poussées restantes (heuristique admissible).
+ * @param niveau t_niveau, description fixe du niveau
+ * @param appariement t_appariement
+ * @return le coût, au moins INFINI_DISTANCE si une caisse ne peut atteindre
+ * aucune cible libre (position perdue)
+ */
+int valeur_appariement(const t_niveau *niveau,
+    const t_appariement *appariement) {
+  int total = 0;
+  for (int j = 1; j <= appariement->n; j++) {
+    total += cout_appariement(niveau, appariement,
+                              appariement->ligneColonne[j], j);
+  }
+  return (total > INFINI_DISTANCE) ? INFINI_DISTANCE : total;
+}
+
+/**
+ * @brief Fonction qui ajoute une entrée dans un seau de la liste ouverte.
+ * @param seau t_seau, en entrer et sortie
+ * @param noeud int, indice du noeud
+ * @param poussees int, nombre de poussées du noeud au moment de l'ajout
+ * @return FAUX si la mémoire manque
+ */
+bool empiler_seau(t_seau *seau, int noeud, int poussees) {
+  if (seau->nb == seau->capacite) {
+    int capacite = (seau->capacite == 0) ? 64 : seau->capacite * 2;
+    t_entree *entrees = realloc(seau->entrees, capacite * sizeof(t_entree));
+    if (entrees == NULL) {
+      return FAUX;
+    }
+    seau->entrees = entrees;
+    seau->capacite = capacite;
+  }
+  seau->entrees[seau->nb].noeud = noeud;
+  seau->entrees[seau->nb].poussees = poussees;
+  seau->nb += 1;
+  return VRAI;
+}
+
+/**
+ * @brief Fonction qui fait une recherche A* sur les poussées avec
+ * l'heuristique d'affectation. La liste ouverte est un tableau de seaux
+ * indexé par f = poussées + heuristique. L'heuristique est cohérente (une
+ * poussée la change d'au plus 1), la première position gagnante sortie a donc
+ * le nombre minimal de poussées.
+ * @param solveur t_solveur, initialisé
+ * @param position t_position, position de départ (modifiée)
+ * @return l'indice du noeud gagnant, AUCUNE_CASE si pas de solution
+ */
+int recherche_astar(t_solveur *solveur, t_position *position) {
+  const t_niveau *niveau = &solveur->niveau;
+  t_masque atteint;
+  bool nouveau, correct = VRAI;
+  t_poussee poussees[NB_DIRECTIONS * MAX_CAISSES];
+  t_appariement appariement, appariementEnfant;
+  t_seau *seaux = NULL;
+  t_entree entree;
+  int nbSeaux = 0, f = 0, h, g, nbPoussees, enfant, but = AUCUNE_CASE;
+
+  position->joueur = acces_joueur(position, niveau, atteint);
+  calculer_appariement(niveau, position, &appariement);
+  h = valeur_appariement(niveau, &appariement);
+  if ((h >= INFINI_DISTANCE) ||
+      (ajouter_noeud(solveur, position, AUCUNE_CASE, AUCUNE_CASE,
+                     AUCUNE_CASE, &nouveau) == AUCUNE_CASE)) {
+    return AUCUNE_CASE;
+  }
+  correct = ajouter_seau(&seaux, &nbSeaux, h, 0, 0);
+  while (correct && (but == AUCUNE_CASE) && (f < nbSeaux)) {
+    if ((solveur->arret != NULL) &&
+        __atomic_load_n(solveur->arret, __ATOMIC_RELAXED)) {
+      break;
+    }
+    if (hors_delai(solveur)) {
+      break;
+    }
+    if (seaux[f].nb == 0) {
+      f++;
+      continue;
+    }
+    // dernier entré d'abord : à f égal on favorise les noeuds profonds
+    entree = seaux[f].entrees[--seaux[f].nb];
+    if (solveur->noeuds[entree.noeud].poussees != entree.poussees) {
+      continue; // un meilleur chemin a été trouvé depuis
+    }
+    placer_etat(position, niveau,
+                &solveur->caisses[(size_t)entree.noeud * solveur->nbCaisses],
+                solveur->noeuds[entree.noeud].joueur);
+    if (position_gagnante(position, niveau)) {
+      but = entree.noeud;
+      continue;
+    }
+    solveur->noeudsDeveloppes += 1;
+    calculer_appariement(niveau, position, &appariement);
+    acces_joueur(position, niveau, atteint);
+    nbPoussees = lister_poussees(position, niveau, atteint, poussees);
+    if (solveur->macros) {
+      etendre_macros(position, niveau, poussees, nbPoussees);
+    }
+    for (int p = 0; (p < nbPoussees) && correct; p++) {
+      if (!jouer_poussee(position, niveau, poussees[p])) {
+        continue;
+      }
+      g = entree.poussees + poussees[p].cout;
+      appariementEnfant = appariement;
+      deplacer_appariement(niveau, &appariementEnfant, poussees[p].depart,
+                           poussees[p].arrivee);
+      h = valeur_appariement(niveau, &appariementEnfant);
+      if (h < INFINI_DISTANCE) {
+        position->joueur = acces_joueur(position, niveau, atteint);
+        enfant = ajouter_noeud(solveur, position, entree.noeud,
+                               poussees[p].depart, poussees[p].arrivee,
+                               &nouveau);
+        if (enfant == AUCUNE_CASE) {
+          solveur->memoirePleine = VRAI;
+          correct = FAUX;
+        } else if (nouveau || (solveur->noeuds[enfant].poussees > g)) {
+          solveur->noeuds[enfant].parent = entree.noeud;
+          solveur->noeuds[enfant].depart = poussees[p].depart;
+          solveur->noeuds[enfant].arrivee = poussees[p].arrivee;
+          solveur->noeuds[enfant].poussees = g;
+          correct = ajouter_seau(&seaux, &nbSeaux, g + h, enfant, g);
+          solveur->memoirePleine = !correct;
+          f = (g + h < f) ? g + h : f;
+        }
+      }
+      annuler_poussee(position, niveau, poussees[p]);
+    }
+  }
+  for (int i = 0; i < nbSeaux; i++) {
+    free(seaux[i].entrees);
+  }
+  free(seaux);
+  return but;
+}
+
+/**
+ * @brief Fonction qui ajoute un noeud dans le seau de valeur f, en agrandissant
+ * le tableau des seaux si besoin.
+ * @param seaux tableau des seaux, en entrer et sortie
+ * @param nbSeaux int, nombre de seaux, en entrer et sortie
+ * @param f int, poussées + heuristique
+ * @param noeud int, indice du noeud
+ * @param poussees int, nombre de poussées du noeud
+ * @return FAUX si la mémoire manque
+ */
+bool ajouter_seau(t_seau **seaux, int *nbSeaux, int f, int noeud,
+    int poussees) {
+  if (f >= *nbSeaux) {
+    int nb = f + 64;
+    t_seau *nouveaux = realloc(*seaux, nb * sizeof(t_seau));
+    if (nouveaux == NULL) {
+      return FAUX;
+    }
+    memset(&nouveaux[*nbSeaux], 0, (nb - *nbSeaux) * sizeof(t_seau));
+    *seaux = nouveaux;
+    *nbSeaux = nb;
+  }
+  return empiler_seau(&(*seaux)[f], noeud, poussees);
+}
+
+/**
+ * @brief Fonction qui fait la recherche en largeur sur les poussées : les
+ * noeuds sont développés dans leur ordre de création, le tableau des noeuds
+ * sert donc aussi de file.
+ * @param solveur t_solveur, initialisé
+ * @param position t_position, position de départ (modifiée)
+ * @return l'indice du noeud gagnant, AUCUNE_CASE si pas de solution
+ */
+int recherche_largeur(t_solveur *solveur, t_position *position) {
+  const t_niveau *niveau = &solveur->niveau;
+  t_masque atteint;
+  bool nouveau;
+  t_poussee poussees[NB_DIRECTIONS * MAX_CAISSES];
+  int nbPoussees, enfant;
+
+  position->joueur = acces_joueur(position, niveau, atteint);
+  if (ajouter_noeud(solveur, position, AUCUNE_CASE, AUCUNE_CASE, AUCUNE_CASE,
+                    &nouveau) == AUCUNE_CASE) {
+    return AUCUNE_CASE;
+  }
+  if (position_gagnante(position, niveau)) {
+    return 0;
+  }
+  for (int n = 0; (n < solveur->nbNoeuds) && !hors_delai(solveur); n++) {
+    placer_etat(position, niveau,
+                &solveur->caisses[(size_t)n * solveur->nbCaisses],
+                solveur->noeuds[n].joueur);
+    acces_joueur(position, niveau, atteint);
+    nbPoussees = lister_poussees(position, niveau, atteint, poussees);
+    solveur->noeudsDeveloppes += 1;
+    for (int p = 0; p < nbPoussees; p++) {
+      if (!jouer_poussee(position, niveau, poussees[p])) {
+        continue;
+      }
+      position->joueur = acces_joueur(position, niveau, atteint);
+      enfant = ajouter_noeud(solveur, position, n, poussees[p].depart,
+                             poussees[p].arrivee, &nouveau);
+      if (enfant == AUCUNE_CASE) {
+        solveur->memoirePleine = VRAI;
+        return AUCUNE_CASE;
+      }
+      if (nouveau && position_gagnante(position, niveau)) {
+        return enfant;
+      }
+      annuler_poussee(position, niveau, poussees[p]);
+    }
+  }
+  return AUCUNE_CASE;
+}
+
+/**
+ * @brief Fonction qui indique si la recherche a dépassé son échéance.
+ * L'horloge n'est lue que tous les 1024 noeuds développés.
+ * @param solveur t_solveur, horsDelai mis à VRAI si l'échéance est passée
+ * @return VRAI si la recherche doit s'arrêter
+ */
+bool hors_delai(t_solveur *solveur) {
+  if ((solveur->echeance > 0) && ((solveur->noeudsDeveloppes & 1023) == 0) &&
+      (maintenant_ms() > solveur->echeance)) {
+    solveur->horsDelai = VRAI;
+  }
+  return solveur->horsDelai;
+}
+
+/**
+ * @brief Fonction qui fait la recherche en largeur sur plusieurs threads. Les
+ * noeuds d'une couche (même nombre de poussées) sont contigus dans le tableau
+ * des noeuds : la couche est découpée en tranches réparties dans une pile par
+ * thread, chaque thread prend ses tranches par le bas et vole celles des
+ * autres par le haut quand il n'en a plus. La table de transposition est
+ * partagée et remplie sans verrou (échange atomique de la clé). Toutes les
+ * couches sont terminées dans l'ordre, la solution a donc toujours le nombre
+ * minimal de poussées.
+ * @param solveur t_solveur, initialisé
+ * @param position t_position, position de départ
+ * @param nbThreads int, nombre de threads
+ * @return l'indice du noeud gagnant, AUCUNE_CASE si pas de solution
+ */
+int recherche_parallele(t_solveur *solveur, t_position *position,
+    int nbThreads) {
+  t_parallele partage;
+  t_travailleur *travailleurs;
+  pthread_t *threads;
+  t_masque atteint;
+  bool nouveau, correct = VRAI;
+  int lances = 0;
+
+  // les noeuds sont réservés d'avance : les threads ne font jamais de realloc
+  if ((solveur->capacite < solveur->maxNoeuds) &&
+      !agrandir_noeuds(solveur, solveur->maxNoeuds)) {
+    solveur->memoirePleine = VRAI;
+    return AUCUNE_CASE;
+  }
+  for (size_t i = 0; i < solveur->table.taille; i++) {
+    solveur->table.valeurs[i] = NOEUD_EN_COURS;
+  }
+  partage.solveur = solveur;
+  partage.nbThreads = nbThreads;
+  partage.but = AUCUNE_CASE;
+  partage.arret = FAUX;
+  partage.fini = FAUX;
+  partage.debutCouche = 0;
+  partage.finCouche = 0;
+  position->joueur = acces_joueur(position, &solveur->niveau, atteint);
+  if (ajouter_noeud(solveur, position, AUCUNE_CASE, AUCUNE_CASE, AUCUNE_CASE,
+                    &nouveau) == AUCUNE_CASE) {
+    return AUCUNE_CASE;
+  }
+  if (position_gagnante(position, &solveur->niveau)) {
+    return 0;
+  }
+  partage.deques = calloc(nbThreads, sizeof(t_deque));
+  travailleurs = malloc(nbThreads * sizeof(t_travailleur));
+  threads = malloc(nbThreads * sizeof(pthread_t));
+  if ((partage.deques == NULL) || (travailleurs == NULL) || (threads == NULL)) {
+    free(partage.deques);
+    free(travailleurs);
+    free(threads);
+    solveur->memoirePleine = VRAI;
+    return AUCUNE_CASE;
+  }
+  for (int t = 0; t < nbThreads; t++) {
+    pthread_mutex_init(&partage.deques[t].verrou, NULL);
+    travailleurs[t].partage = &partage;
+    travailleurs[t].numero = t;
+    travailleurs[t].position = *position;
+  }
+  pthread_barrier_init(&partage.barriere, NULL, nbThreads);
+  distribuer_couche(&partage);
+  // le thread appelant est le travailleur 0
+  for (int t = 1; (t < nbThreads) && correct; t++) {
+    correct = (pthread_create(&threads[t], NULL, travailleur_largeur,
+                              &travailleurs[t]) == 0);
+    lances += correct;
+  }
+  if (!correct) {
+    // les threads lancés attendent à la barrière : on ne peut pas continuer
+    fprintf(stderr, "impossible de lancer %d threads\n", nbThreads);
+    exit(EXIT_FAILURE);
+  }
+  travailleur_largeur(&travailleurs[0]);
+  for (int t = 1; t <= lances; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  pthread_barrier_destroy(&partage.barriere);
+  for (int t = 0; t < nbThreads; t++) {
+    pthread_mutex_destroy(&partage.deques[t].verrou);
+    free(partage.deques[t].tranches);
+  }
+  if (solveur->nbNoeuds > solveur->maxNoeuds) {
+    solveur->nbNoeuds = solveur->maxNoeuds;
+  }
+  free(partage.deques);
+  free(travailleurs);
+  free(threads);
+  return partage.but;
+}
+
+/**
+ * @brief Fonction exécutée par chaque thread de la recherche parallèle :
+ * développe les tranches de la couche puis attend les autres threads.
+ * @param argument t_travailleur, données du thread
+ * @return NULL
+ */
+void *travailleur_largeur(void *argument) {
+  t_travailleur *travailleur = argument;
+  t_parallele *partage = travailleur->partage;
+  t_solveur *solveur = partage->solveur;
+  const t_niveau *niveau = &solveur->niveau;
+  t_position *position = &travailleur->position;
+  t_poussee poussees[NB_DIRECTIONS * MAX_CAISSES];
+  t_masque atteint;
+  bool nouveau;
+  t_tranche tranche;
+  int nbPoussees, enfant, sansBut = AUCUNE_CASE;
+  long developpes;
+
+  // fini n'est écrit qu'entre les deux barrières : tous les threads le
+  // lisent avec la même valeur
+  while (!partage->fini) {
+    developpes = 0;
+    while (prendre_tranche(partage, travailleur->numero, &tranche)) {
+      for (int n = tranche.debut; n < tranche.fin; n++) {
+        if (__atomic_load_n(&partage->arret, __ATOMIC_RELAXED)) {
+          break;
+        }
+        placer_etat(position, niveau,
+                    &solveur->caisses[(size_t)n * solveur->nbCaisses],
+                    solveur->noeuds[n].joueur);
+        acces_joueur(position, niveau, atteint);
+        nbPoussees = lister_poussees(position, niveau, atteint, poussees);
+        developpes++;
+        // comme hors_delai(), l'horloge n'est lue que tous les 1024 noeuds
+        if ((solveur->echeance > 0) && ((developpes & 1023) == 0) &&
+            (maintenant_ms() > solveur->echeance)) {
+          __atomic_store_n(&solveur->horsDelai, VRAI, __ATOMIC_RELAXED);
+          __atomic_store_n(&partage->arret, VRAI, __ATOMIC_RELEASE);
+        }
+        for (int p = 0; p < nbPoussees; p++) {
+          if (!jouer_poussee(position, niveau, poussees[p])) {
+            continue;
+          }
+          position->joueur = acces_joueur(position, niveau, atteint);
+          enfant = ajouter_noeud_partage(partage, position, n,
+                                         poussees[p].depart,
+                                         poussees[p].arrivee, &nouveau);
+          if ((enfant != AUCUNE_CASE) && nouveau &&
+              position_gagnante(position, niveau)) {
+            sansBut = AUCUNE_CASE;
+            __atomic_compare_exchange_n(&partage->but, &sansBut, enfant,
+                                        FAUX, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED);
+            __atomic_store_n(&partage->arret, VRAI, __ATOMIC_RELEASE);
+          }
+          annuler_poussee(position, niveau, poussees[p]);
+        }
+      }
+    }
+    __atomic_add_fetch(&solveur->noeudsDeveloppes, developpes,
+                       __ATOMIC_RELAXED);
+    // fin de couche : le travailleur 0 prépare la suivante pendant que les
+    // autres attendent à la seconde barrière
+    pthread_barrier_wait(&partage->barriere);
+    if (travailleur->numero == 0) {
+      distribuer_couche(partage);
+    }
+    pthread_barrier_wait(&partage->barriere);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Procédure qui découpe la couche suivante en tranches et les répartit
+ * dans les piles des threads. Arrête la recherche si la couche est vide, si
+ * une solution a été trouvée, si la mémoire est pleine ou si l'échéance est
+ * passée.
+ * @param partage t_parallele, données partagées
+ */
+void distribuer_couche(t_parallele *partage) {
+  t_solveur *solveur = partage->solveur;
+  int fin = solveur->nbNoeuds, nbTranches, parThread;
+  if (fin > solveur->maxNoeuds) {
+    fin = solveur->maxNoeuds;
+  }
+  partage->debutCouche = partage->finCouche;
+  partage->finCouche = fin;
+  nbTranches = (fin - partage->debutCouche + TAILLE_TRANCHE - 1) /
+               TAILLE_TRANCHE;
+  parThread = nbTranches / partage->nbThreads + 1;
+  if ((nbTranches == 0) || (partage->but != AUCUNE_CASE) ||
+      solveur->memoirePleine || solveur->horsDelai) {
+    partage->fini = VRAI;
+    return;
+  }
+  for (int t = 0; t < partage->nbThreads; t++) {
+    t_deque *deque = &partage->deques[t];
+    if (deque->capacite < parThread) {
+      t_tranche *tranches = realloc(deque->tranches,
+                                    parThread * sizeof(t_tranche));
+      if (tranches == NULL) {
+        solveur->memoirePleine = VRAI;
+        partage->fini = VRAI;
+        return;
+      }
+      deque->tranches = tranches;
+      deque->capacite = parThread;
+    }
+    deque->haut = 0;
+    deque->bas = 0;
+  }
+  for (int i = 0; i < nbTranches; i++) {
+    t_deque *deque = &partage->deques[i % partage->nbThreads];
+    deque->tranches[deque->bas].debut = partage->debutCouche + i * TAILLE_TRANCHE;
+    deque->tranches[deque->bas].fin =
+        (partage->debutCouche + (i + 1) * TAILLE_TRANCHE < fin)
+            ? partage->debutCouche + (i + 1) * TAILLE_TRANCHE
+            : fin;
+    deque->bas += 1;
+  }
+}
+
+/**
+ * @brief Fonction qui donne une tranche à développer : d'abord le bas de la
+ * pile du thread, sinon le haut de la pile d'un autre thread (vol).
+ * @param partage t_parallele, données partagées
+ * @param numero int, numéro du thread
+ * @param tranche t_tranche, en sortie
+ * @return FAUX si toutes les piles sont vides
+ */
+bool prendre_tranche(t_parallele *partage, int numero, t_tranche *tranche) {
+  bool trouve = FAUX;
+  t_deque *deque = &partage->deques[numero];
+  pthread_mutex_lock(&deque->verrou);
+  if (deque->bas > deque->haut) {
+    deque->bas -= 1;
+    *tranche = deque->tranches[deque->bas];
+    trouve = VRAI;
+  }
+  pthread_mutex_unlock(&deque->verrou);
+  for (int k = 1; (k < partage->nbThreads) && !trouve; k++) {
+    deque = &partage->deques[(numero + k) % partage->nbThreads];
+    pthread_mutex_lock(&deque->verrou);
+    if (deque->bas > deque->haut) {
+      *tranche = deque->tranches[deque->haut];
+      deque->haut += 1;
+      trouve = VRAI;
+    }
+    pthread_mutex_unlock(&deque->verrou);
+  }
+  return trouve;
+}
+
+/**
+ * @brief Fonction qui ajoute un noeud dans la table partagée. Un thread
+ * réserve une alvéole vide en y écrivant la clé par échange atomique, puis
+ * publie l'indice du noeud une fois celui-ci écrit ; un thread qui trouve la
+ * même clé attend cette publication avant de comparer les états.
+ * @param partage t_parallele, données partagées
+ * @param position t_position, position avec le joueur normalisé
+ * @param parent int, indice du noeud parent
+ * @param depart int, case de la caisse avant la poussée
+ * @param arrivee int, case de la caisse après la poussée
+ * @param nouveau bool, VRAI si le noeud vient d'être créé, en sortie
+ * @return l'indice du noeud, AUCUNE_CASE si la mémoire est pleine
+ */
+int ajouter_noeud_partage(t_parallele *partage, const t_position *position,
+    int parent, int depart, int arrivee, bool *nouveau) {
+  t_solveur *solveur = partage->solveur;
+  t_table *table = &solveur->table;
+  int k = solveur->nbCaisses, i;
+  uint64_t cle = cle_position(position, &solveur->niveau), present;
+  size_t alveole = cle & (table->taille - 1);
+  *nouveau = FAUX;
+  while (VRAI) {
+    present = 0;
+    if (__atomic_compare_exchange_n(&table->cles[alveole], &present, cle,
+                                    FAUX, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE)) {
+      i = __atomic_fetch_add(&solveur->nbNoeuds, 1, __ATOMIC_RELAXED);
+      if (i >= solveur->maxNoeuds) {
+        __atomic_store_n(&solveur->memoirePleine, VRAI, __ATOMIC_RELAXED);
+        __atomic_store_n(&partage->arret, VRAI, __ATOMIC_RELEASE);
+        __atomic_store_n(&table->valeurs[alveole], NOEUD_ABSENT,
+                         __ATOMIC_RELEASE);
+        return AUCUNE_CASE;
+      }
+      solveur->noeuds[i].parent = parent;
+      solveur->noeuds[i].depart = depart;
+      solveur->noeuds[i].arrivee = arrivee;
+      solveur->noeuds[i].joueur = position->joueur;
+      solveur->noeuds[i].poussees = solveur->noeuds[parent].poussees + 1;
+      memcpy(&solveur->caisses[(size_t)i * k], position->caisses,
+             k * sizeof(short));
+      __atomic_store_n(&table->valeurs[alveole], i, __ATOMIC_RELEASE);
+      *nouveau = VRAI;
+      return i;
+    }
+    if (present == cle) {
+      while ((i = __atomic_load_n(&table->valeurs[alveole],
+                                  __ATOMIC_ACQUIRE)) == NOEUD_EN_COURS) {
+        sched_yield();
+      }
+      if (i == NOEUD_ABSENT) {
+        return AUCUNE_CASE;
+      }
+      if ((solveur->noeuds[i].joueur == position->joueur) &&
+          (memcmp(&solveur->caisses[(size_t)i * k], position->caisses,
+                  k * sizeof(short)) == 0)) {
+        return i;
+      }
+    }
+    alveole = (alveole + 1) & (table->taille - 1);
+  }
+}
+
+/**
+ * @brief Fonction qui agrandit les tableaux des noeuds du solveur.
+ * @param solveur t_solveur
+ * @param capacite int, nouvelle capacité (au plus maxNoeuds)
+ * @return FAUX si la mémoire manque
+ */
+bool agrandir_noeuds(t_solveur *solveur, int capacite) {
+  t_noeud *noeuds = realloc(solveur->noeuds, capacite * sizeof(t_noeud));
+  if (noeuds == NULL) {
+    return FAUX;
+  }
+  solveur->noeuds = noeuds;
+  short *caisses = realloc(solveur->caisses,
+                           (size_t)capacite * solveur->nbCaisses * sizeof(short));
+  if (caisses == NULL) {
+    return FAUX;
+  }
+  solveur->caisses = caisses;
+  solveur->capacite = capacite;
+  return VRAI;
+}
+
+/**
+ * @brief Fonction qui fait la recherche bidirectionnelle : en avant par
+ * poussées depuis la position de départ, en arrière par tirages depuis les
+ * caisses sur les cibles (une position de départ par zone possible du
+ * joueur). Chaque couche complète est développée du côté dont la frontière
+ * est la plus petite ; un noeud créé est cherché dans la table de l'autre
+ * recherche, la première couche qui produit une rencontre donne la solution
+ * avec le moins de poussées. Il faut autant de caisses que de cibles.
+ * @param avant t_solveur, recherche en avant, initialisé
+ * @param arriere t_solveur, recherche en arrière, initialisé
+ * @param position t_position, position de départ (modifiée)
+ * @param rencontre t_rencontre, noeuds communs aux deux recherches, en sortie
+ * @return VRAI si les deux recherches se sont rencontrées
+ */
+bool recherche_bidirectionnelle(t_solveur *avant, t_solveur *arriere,
+    t_position *position, t_rencontre *rencontre) {
+  const t_niveau *niveau = &avant->niveau;
+  t_position but = *position;
+  short cibles[MAX_CAISSES] = {0};
+  t_masque atteint;
+  t_masque couvert = {0};
+  bool nouveau;
+  int nb = 0, debutAvant = 0, debutArriere = 0, fin;
+
+  rencontre->avant = AUCUNE_CASE;
+  rencontre->arriere = AUCUNE_CASE;
+  rencontre->poussees = INT_MAX;
+  position->joueur = acces_joueur(position, niveau, atteint);
+  if (ajouter_noeud(avant, position, AUCUNE_CASE, AUCUNE_CASE, AUCUNE_CASE,
+                    &nouveau) == AUCUNE_CASE) {
+    avant->memoirePleine = VRAI;
+    return FAUX;
+  }
+  // départs de la recherche en arrière : caisses sur les cibles, joueur dans
+  // chacune des zones séparées par les caisses
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (niveau->cible[laCase]) {
+      cibles[nb++] = laCase;
+    }
+  }
+  placer_etat(&but, niveau, cibles, AUCUNE_CASE);
+  for (int laCase = 0; laCase < niveau->nbCases; laCase++) {
+    if (masque_contient(couvert, laCase) || !est_libre(but.cases[laCase])) {
+      continue;
+    }
+    but.joueur = laCase;
+    but.joueur = acces_joueur(&but, niveau, atteint);
+    for (int m = 0; m < niveau->nbMots; m++) {
+      couvert[m] |= atteint[m];
+    }
+    if (ajouter_noeud(arriere, &but, AUCUNE_CASE, AUCUNE_CASE, AUCUNE_CASE,
+                      &nouveau) == AUCUNE_CASE) {
+      arriere->memoirePleine = VRAI;
+      return FAUX;
+    }
+    if (chercher_noeud(avant, &but) != AUCUNE_CASE) {
+      noter_rencontre(avant, arriere, 0, arriere->nbNoeuds - 1, rencontre);
+    }
+  }
+  while ((rencontre->poussees == INT_MAX) && (debutAvant < avant->nbNoeuds) &&
+         (debutArriere < arriere->nbNoeuds)) {
+    if (avant->nbNoeuds - debutAvant <= arriere->nbNoeuds - debutArriere) {
+      fin = avant->nbNoeuds;
+      if (!developper_couche(avant, arriere, &but, FAUX, debutAvant,
+                             rencontre)) {
+        return FAUX;
+      }
+      debutAvant = fin;
+    } else {
+      fin = arriere->nbNoeuds;
+      if (!developper_couche(arriere, avant, &but, VRAI, debutArriere,
+                             rencontre)) {
+        return FAUX;
+      }
+      debutArriere = fin;
+    }
+  }
+  return rencontre->poussees != INT_MAX;
+}
+
+/**
+ * @brief Fonction qui développe une couche complète d'une des deux recherches
+ * de recherche_bidirectionnelle() et note les rencontres avec l'autre.
+ * @param solveur t_solveur, recherche développée
+ * @param autre t_solveur, l'autre recherche
+ * @param position t_position, position de travail
+ * @param tirer bool, VRAI pour la recherche en arrière (tirages)
+ * @param debut int, premier noeud de la couche, la couche va jusqu'au dernier
+ * noeud existant
+ * @param rencontre t_rencontre, meilleure rencontre, en entrer et sortie
+ * @return FAUX si la mémoire est pleine
+ */
+bool developper_couche(t_solveur *solveur, const t_solveur *autre,
+    t_position *position, bool tirer, int debut, t_rencontre *rencontre) {
+  const t_niveau *niveau = &solveur->niveau;
+  t_poussee mouvements[NB_DIRECTIONS * MAX_CAISSES];
+  t_masque atteint;
+  bool nouveau;
+  int fin = solveur->nbNoeuds, nbMouvements, enfant, commun;
+
+  for (int n = debut; n < fin; n++) {
+    placer_etat(position, niveau,
+                &solveur->caisses[(size_t)n * solveur->nbCaisses],
+                solveur->noeuds[n].joueur);
+    acces_joueur(position, niveau, atteint);
+    nbMouvements = tirer ? lister_tirages(position, niveau, atteint, mouvements)
+                         : lister_poussees(position, niveau, atteint,
+                                           mouvements);
+    solveur->noeudsDeveloppes += 1;
+    for (int m = 0; m < nbMouvements; m++) {
+      if (tirer) {
+        tirer_caisse(position, niveau, mouvements[m]);
+      } else if (!jouer_poussee(position, niveau, mouvements[m])) {
+        continue;
+      }
+      position->joueur = acces_joueur(position, niveau, atteint);
+      enfant = ajouter_noeud(solveur, position, n, mouvements[m].depart,
+                             mouvements[m].arrivee, &nouveau);
+      if (enfant == AUCUNE_CASE) {
+        solveur->memoirePleine = VRAI;
+        return FAUX;
+      }
+      commun = nouveau ? chercher_noeud(autre, position) : AUCUNE_CASE;
+      if (commun != AUCUNE_CASE) {
+        if (tirer) {
+          noter_rencontre(autre, solveur, commun, enfant, rencontre);
+        } else {
+          noter_rencontre(solveur, autre, enfant, commun, rencontre);
+        }
+      }
+      if (tirer) {
+        pousser_caisse(position, niveau, mouvements[m].arrivee,
+                       mouvements[m].depart);
+      } else {
+        annuler_poussee(position, niveau, mouvements[m]);
+      }
+    }
+  }
+  return VRAI;
+}
+
+/**
+ * @brief Procédure qui garde la rencontre la plus courte.
+ * @param avant t_solveur, recherche en avant
+ * @param arriere t_solveur, recherche en arrière
+ * @param noeudAvant int, noeud de la recherche en avant
+ * @param noeudArriere int, noeud de la même position dans la recherche en
+ * arrière
+ * @param rencontre t_rencontre, meilleure rencontre, en entrer et sortie
+ */
+void noter_rencontre(const t_solveur *avant, const t_solveur *arriere,
+    int noeudAvant, int noeudArriere, t_rencontre *rencontre) {
+  int poussees = avant->noeuds[noeudAvant].poussees +
+                 arriere->noeuds[noeudArriere].poussees;
+  if (poussees < rencontre->poussees) {
+    rencontre->avant = noeudAvant;
+    rencontre->arriere = noeudArriere;
+    rencontre->poussees = poussees;
+  }
+}
+
+/**
+ * @brief Fonction qui liste les tirages possibles depuis une position : le
+ * joueur atteint une case voisine d'une caisse et la case derrière lui est
+ * libre, il recule et la caisse le suit. C'est le mouvement que fait
+ * annuler_deplacement() pour une poussée HBGD.
+ * @param position t_position, position de travail
+ * @param niveau t_niveau, description fixe du niveau
+ * @param atteint tableau des cases atteignables par le joueur
+ * @param tirages tableau des tirages (case de la caisse avant et après),
+ * en sortie
+ * @return le nombre de tirages
+ */
+int lister_tirages(const t_position *position, const t_niveau *niveau,
+    const t_masque atteint, t_poussee tirages[]) {
+  int nb = 0, caisse, joueur;
+  for (int i = 0; i < position->nbCaisses; i++) {
+    caisse = position->caisses[i];
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      joueur = caisse + niveau->decalage[d];
+      if (masque_contient(atteint, joueur) &&
+          est_libre(position->cases[joueur + niveau->decalage[d]])) {
+        tirages[nb].depart = caisse;
+        tirages[nb].arrivee = joueur;
+        tirages[nb].joueur = joueur + niveau->decalage[d];
+        tirages[nb].cout = 1;
+        nb++;
+      }
+    }
+  }
+  return nb;
+}
+
+/**
+ * @brief Procédure qui tire une caisse : la caisse prend la case du joueur et
+ * le joueur recule d'une case. pousser_caisse() en sens inverse l'annule.
+ * @param position t_position, position de travail, en entrer et sortie
+ * @param niveau t_niveau, description fixe du niveau
+ * @param tirage t_poussee, case de la caisse avant et après
+ */
+void tirer_caisse(t_position *position, const t_niveau *niveau,
+    t_poussee tirage) {
+  pousser_caisse(position, niveau, tirage.depart, tirage.arrivee);
+  position->joueur = 2 * tirage.arrivee - tirage.depart;
+}
+
+/**
+ * @brief Fonction qui cherche une position dans la table de transposition sans
+ * l'ajouter.
+ * @param solveur t_solveur
+ * @param position t_position, position avec le joueur normalisé
+ * @return l'indice du noeud, AUCUNE_CASE s'il n'existe pas
+ */
+int chercher_noeud(const t_solveur *solveur, const t_position *position) {
+  int k = solveur->nbCaisses, i;
+  const t_table *table = &solveur->table;
+  uint64_t cle = cle_position(position, &solveur->niveau);
+  size_t alveole = cle & (table->taille - 1);
+  while (table->cles[alveole] != 0) {
+    i = table->valeurs[alveole];
+    if ((table->cles[alveole] == cle) &&
+        (solveur->noeuds[i].joueur == position->joueur) &&
+        (memcmp(&solveur->caisses[(size_t)i * k], position->caisses,
+                k * sizeof(short)) == 0)) {
+      return i;
+    }
+    alveole = (alveole + 1) & (table->taille - 1);
+  }
+  return AUCUNE_CASE;
+}
+
+/**
+ * @brief Fonction qui met bout à bout les poussées des deux recherches : la
+ * recherche en avant jusqu'à la rencontre, puis les tirages de la recherche en
+ * arrière joués à l'envers jusqu'aux cibles.
+ * @param avant t_solveur, recherche en avant
+ * @param arriere t_solveur, recherche en arrière
+ * @param rencontre t_rencontre, noeuds communs
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @return le nombre de poussées
+ */
+int extraire_rencontre(const t_solveur *avant, const t_solveur *arriere,
+    const t_rencontre *rencontre, short depart[], short arrivee[]) {
+  int nb = extraire_poussees(avant, rencontre->avant, depart, arrivee);
+  for (int i = rencontre->arriere; arriere->noeuds[i].parent != AUCUNE_CASE;
+       i = arriere->noeuds[i].parent) {
+    depart[nb] = arriere->noeuds[i].arrivee;
+    arrivee[nb] = arriere->noeuds[i].depart;
+    nb++;
+  }
+  return nb;
+}
+
+/**
+ * @brief Fonction qui fait la recherche en largeur sur disque, pour les
+ * niveaux dont les positions ne tiennent pas en mémoire. Chaque couche est
+ * un fichier d'enregistrements triés (caisses, joueur normalisé, poussée qui
+ * y mène). Les enfants d'une couche sont accumulés dans un tampon de taille
+ * bornée, triés et écrits en séquences triées, puis les séquences sont
+ * fusionnées et les positions déjà vues (fichier trié de toutes les couches
+ * précédentes) retirées en un seul passage. La mémoire utilisée ne dépend
+ * que du tampon.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, position de départ (modifiée)
+ * @param dossier chaîne, dossier des fichiers temporaires
+ * @param memoireMo long, taille du tampon en Mo
+ * @param echeance long, heure limite en ms (maintenant_ms()), 0 sans limite ;
+ * l'horloge est lue tous les 1024 enregistrements développés
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @param noeudsDeveloppes long, nombre de positions développées, en sortie
+ * @param horsDelai bool, VRAI si l'échéance a arrêté la recherche, en sortie
+ * @return le nombre de poussées, AUCUNE_CASE si pas de solution
+ */
+int recherche_disque(const t_niveau *niveau, t_position *position,
+    const char *dossier, long memoireMo, long echeance, short depart[],
+    short arrivee[], long *noeudsDeveloppes, bool *horsDelai) {
+  t_disque disque;
+  t_poussee poussees[NB_DIRECTIONS * MAX_CAISSES];
+  t_masque atteint;
+  short lu[MAX_CAISSES + 3], but[MAX_CAISSES + 3];
+  char nom[TAILLE_NOM_DISQUE];
+  FILE *couche;
+  int nbPoussees, profondeur = 0, resultat = AUCUNE_CASE;
+  long nbNouveaux = 1;
+  bool trouve = FAUX;
+
+  init_disque(&disque, dossier, position->nbCaisses, memoireMo);
+  *noeudsDeveloppes = 0;
+  *horsDelai = FAUX;
+  position->joueur = acces_joueur(position, niveau, atteint);
+  memcpy(lu, position->caisses, disque.nbCaisses * sizeof(short));
+  lu[disque.nbCaisses] = position->joueur;
+  lu[disque.nbCaisses + 1] = AUCUNE_CASE;
+  lu[disque.nbCaisses + 2] = AUCUNE_CASE;
+  if (position_gagnante(position, niveau)) {
+    liberer_disque(&disque, 0);
+    return 0;
+  }
+  // couche 0 et positions vues : la seule position de départ
+  nom_disque(&disque, "couche", 0, nom);
+  couche = ouvrir_disque(nom, "wb");
+  ecrire_disque(lu, disque.taille, couche);
+  fermer_disque(couche);
+  nom_disque(&disque, "vues", 0, nom);
+  couche = ouvrir_disque(nom, "wb");
+  ecrire_disque(lu, disque.taille, couche);
+  fermer_disque(couche);
+  while ((nbNouveaux > 0) && !trouve && !*horsDelai) {
+    nom_disque(&disque, "couche", profondeur, nom);
+    couche = ouvrir_disque(nom, "rb");
+    while (!trouve && !*horsDelai &&
+           (fread(lu, sizeof(short), disque.taille, couche) ==
+            (size_t)disque.taille)) {
+      *noeudsDeveloppes += 1;
+      if ((echeance > 0) && ((*noeudsDeveloppes & 1023) == 0) &&
+          (maintenant_ms() > echeance)) {
+        *horsDelai = VRAI; // les fichiers temporaires sont effacés plus bas
+        continue;
+      }
+      placer_etat(position, niveau, lu, lu[disque.nbCaisses]);
+      acces_joueur(position, niveau, atteint);
+      nbPoussees = lister_poussees(position, niveau, atteint, poussees);
+      for (int p = 0; (p < nbPoussees) && !trouve; p++) {
+        if (!jouer_poussee(position, niveau, poussees[p])) {
+          continue;
+        }
+        position->joueur = acces_joueur(position, niveau, atteint);
+        memcpy(but, position->caisses, disque.nbCaisses * sizeof(short));
+        but[disque.nbCaisses] = position->joueur;
+        but[disque.nbCaisses + 1] = poussees[p].depart;
+        but[disque.nbCaisses + 2] = poussees[p].arrivee;
+        // une position gagnante ne peut pas avoir été vue avant
+        trouve = position_gagnante(position, niveau);
+        if (!trouve) {
+          ajouter_tampon(&disque, but);
+        }
+        annuler_poussee(position, niveau, poussees[p]);
+      }
+    }
+    fclose(couche);
+    if (!trouve && !*horsDelai) {
+      vider_tampon(&disque);
+      fusionner_sequences(&disque);
+      nbNouveaux = retirer_vues(&disque, profondeur + 1);
+      profondeur += 1;
+    }
+  }
+  if (trouve) {
+    resultat = remonter_disque(&disque, niveau, position, but,
+                               profondeur + 1, depart, arrivee);
+  }
+  liberer_disque(&disque, profondeur + 1);
+  return resultat;
+}
+
+/**
+ * @brief Procédure qui prépare la recherche sur disque : taille des
+ * enregistrements et tampon de tri.
+ * @param disque t_disque, en sortie
+ * @param dossier chaîne, dossier des fichiers temporaires
+ * @param nbCaisses int, nombre de caisses
+ * @param memoireMo long, taille du tampon en Mo
+ */
+void init_disque(t_disque *disque, const char *dossier, int nbCaisses,
+    long memoireMo) {
+  disque->dossier = dossier;
+  disque->processus = getpid();
+  disque->nbCaisses = nbCaisses;
+  disque->taille = nbCaisses + 3;
+  disque->tailleCle = nbCaisses + 1;
+  disque->nbSequences = 0;
+  disque->nbTampon = 0;
+  disque->capaciteTampon = (size_t)memoireMo * 1024 * 1024 /
+                           (disque->taille * sizeof(short));
+  disque->tampon =
+      malloc(disque->capaciteTampon * disque->taille * sizeof(short));
+  if ((disque->tampon == NULL) || (disque->capaciteTampon == 0)) {
+    fprintf(stderr, "mémoire insuffisante pour le tampon de tri\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Procédure qui libère le tampon et efface les fichiers temporaires.
+ * @param disque t_disque
+ * @param nbCouches int, nombre de fichiers de couche écrits
+ */
+void liberer_disque(t_disque *disque, int nbCouches) {
+  char nom[TAILLE_NOM_DISQUE];
+  for (int c = 0; c <= nbCouches; c++) {
+    nom_disque(disque, "couche", c, nom);
+    remove(nom);
+  }
+  for (int s = 0; s < disque->nbSequences; s++) {
+    nom_disque(disque, "sequence", s, nom);
+    remove(nom);
+  }
+  nom_disque(disque, "vues", 0, nom);
+  remove(nom);
+  nom_disque(disque, "fusion", 0, nom);
+  remove(nom);
+  free(disque->tampon);
+  disque->tampon = NULL;
+}
+
+/**
+ * @brief Procédure qui donne le nom d'un fichier temporaire, le numéro du
+ * processus évite les conflits entre deux résolutions dans le même dossier.
+ * @param disque t_disque
+ * @param sorte chaîne, "couche", "sequence" ou "vues"
+ * @param numero int, numéro du fichier
+ * @param nom chaîne, en sortie
+ */
+void nom_disque(const t_disque *disque, const char *sorte, int numero,
+    char nom[]) {
+  snprintf(nom, TAILLE_NOM_DISQUE, "%s/sokoban-%d-%s-%d.bin", disque->dossier,
+           disque->processus, sorte, numero);
+}
+
+/**
+ * @brief Fonction qui ouvre un fichier temporaire, arrête le programme en cas
+ * d'erreur comme charger_partie().
+ * @param nom chaîne, nom du fichier
+ * @param mode chaîne, mode de fopen()
+ * @return le fichier ouvert
+ */
+FILE *ouvrir_disque(const char *nom, const char *mode) {
+  FILE *f = fopen(nom, mode);
+  if (f == NULL) {
+    fprintf(stderr, "ERREUR SUR FICHIER %s\n", nom);
+    exit(EXIT_FAILURE);
+  }
+  return f;
+}
+
+/**
+ * @brief Procédure qui écrit des valeurs dans un fichier temporaire, arrête
+ * le programme si l'écriture échoue (disque plein) : une couche tronquée
+ * ferait conclure à tort qu'il n'y a pas de solution.
+ * @param valeurs tableau, valeurs à écrire
+ * @param nb int, nombre de valeurs
+ * @param f FILE*, fichier ouvert en écriture
+ */
+void ecrire_disque(const short valeurs[], int nb, FILE *f) {
+  if (fwrite(valeurs, sizeof(short), nb, f) != (size_t)nb) {
+    fprintf(stderr, "ERREUR SUR FICHIER : écriture impossible\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Procédure qui ferme un fichier temporaire écrit, arrête le
+ * programme si la fin du tampon ne peut pas être écrite.
+ * @param f FILE*, fichier ouvert en écriture
+ */
+void fermer_disque(FILE *f) {
+  if (fclose(f) != 0) {
+    fprintf(stderr, "ERREUR SUR FICHIER : écriture impossible\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Fonction qui compare les clés (caisses puis joueur) de deux
+ * enregistrements.
+ * @param a premier enregistrement
+ * @param b second enregistrement
+ * @param tailleCle int, nombre de valeurs de la clé
+ * @return négatif, nul ou positif comme strcmp()
+ */
+int comparer_cles(const short a[], const short b[], int tailleCle) {
+  for (int i = 0; i < tailleCle; i++) {
+    if (a[i] != b[i]) {
+      return a[i] - b[i];
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Procédure qui ajoute un enregistrement au tampon et écrit le tampon
+ * en séquence triée quand il est plein.
+ * @param disque t_disque
+ * @param enregistrement tableau, l'enregistrement
+ */
+void ajouter_tampon(t_disque *disque, const short enregistrement[]) {
+  if (disque->nbTampon == disque->capaciteTampon) {
+    vider_tampon(disque);
+  }
+  memcpy(&disque->tampon[disque->nbTampon * disque->taille], enregistrement,
+         disque->taille * sizeof(short));
+  disque->nbTampon += 1;
+}
+
+/**
+ * @brief Procédure qui trie le tampon (tri par tas, sans mémoire en plus) et
+ * l'écrit sans doublons dans une nouvelle séquence. Au-delà de MAX_SEQUENCES
+ * séquences, elles sont d'abord fusionnées en une seule.
+ * @param disque t_disque
+ */
+void vider_tampon(t_disque *disque) {
+  char nom[TAILLE_NOM_DISQUE];
+  int t = disque->taille;
+  short *tampon = disque->tampon, *dernier = NULL;
+  FILE *f;
+  if (disque->nbTampon == 0) {
+    return;
+  }
+  if (disque->nbSequences == MAX_SEQUENCES) {
+    fusionner_sequences(disque);
+  }
+  for (size_t i = disque->nbTampon / 2; i-- > 0;) {
+    tamiser(disque, i, disque->nbTampon);
+  }
+  for (size_t fin = disque->nbTampon - 1; fin > 0; fin--) {
+    echanger_enregistrements(&tampon[0], &tampon[fin * t], t);
+    tamiser(disque, 0, fin);
+  }
+  nom_disque(disque, "sequence", disque->nbSequences, nom);
+  f = ouvrir_disque(nom, "wb");
+  for (size_t i = 0; i < disque->nbTampon; i++) {
+    if ((dernier == NULL) ||
+        (comparer_cles(dernier, &tampon[i * t], disque->tailleCle) != 0)) {
+      ecrire_disque(&tampon[i * t], t, f);
+      dernier = &tampon[i * t];
+    }
+  }
+  fermer_disque(f);
+  disque->nbSequences += 1;
+  disque->nbTampon = 0;
+}
+
+/**
+ * @brief Procédure du tri par tas : fait descendre un enregistrement du tas
+ * jusqu'à sa place.
+ * @param disque t_disque, le tas est le tampon
+ * @param i size_t, indice de l'enregistrement
+ * @param nb size_t, taille du tas
+ */
+void tamiser(t_disque *disque, size_t i, size_t nb) {
+  int t = disque->taille;
+  short *tampon = disque->tampon;
+  size_t plusGrand, enfant;
+  while (VRAI) {
+    plusGrand = i;
+    for (enfant = 2 * i + 1; (enfant <= 2 * i + 2) && (enfant < nb);
+         enfant++) {
+      if (comparer_cles(&tampon[enfant * t], &tampon[plusGrand * t],
+                        disque->tailleCle) > 0) {
+        plusGrand = enfant;
+      }
+    }
+    if (plusGrand == i) {
+      return;
+    }
+    echanger_enregistrements(&tampon[i * t], &tampon[plusGrand * t], t);
+    i = plusGrand;
+  }
+}
+
+/**
+ * @brief Procédure qui échange deux enregistrements.
+ * @param a premier enregistrement
+ * @param b second enregistrement
+ * @param taille int, nombre de valeurs d'un enregistrement
+ */
+void echanger_enregistrements(short a[], short b[], int taille) {
+  short temporaire;
+  for (int i = 0; i < taille; i++) {
+    temporaire = a[i];
+    a[i] = b[i];
+    b[i] = temporaire;
+  }
+}
+
+/**
+ * @brief Procédure qui fusionne toutes les séquences triées en une seule
+ * (séquence 0), sans doublons.
+ * @param disque t_disque
+ */
+void fusionner_sequences(t_disque *disque) {
+  char nom[TAILLE_NOM_DISQUE], nomFusion[TAILLE_NOM_DISQUE];
+  FILE *sequences[MAX_SEQUENCES], *fusion;
+  short tetes[MAX_SEQUENCES][MAX_CAISSES + 3], dernier[MAX_CAISSES + 3];
+  bool actif[MAX_SEQUENCES], premier = VRAI;
+  int t = disque->taille, nb, plusPetit;
+  nb = disque->nbSequences;
+  if (nb <= 1) {
+    return;
+  }
+  for (int s = 0; s < nb; s++) {
+    nom_disque(disque, "sequence", s, nom);
+    sequences[s] = ouvrir_disque(nom, "rb");
+    actif[s] = (fread(tetes[s], sizeof(short), t, sequences[s]) == (size_t)t);
+  }
+  nom_disque(disque, "fusion", 0, nomFusion);
+  fusion = ouvrir_disque(nomFusion, "wb");
+  while (VRAI) {
+    plusPetit = AUCUNE_CASE;
+    for (int s = 0; s < nb; s++) {
+      if (actif[s] && ((plusPetit == AUCUNE_CASE) ||
+                       (comparer_cles(tetes[s], tetes[plusPetit],
+                                      disque->tailleCle) < 0))) {
+        plusPetit = s;
+      }
+    }
+    if (plusPetit == AUCUNE_CASE) {
+      break;
+    }
+    if (premier || (comparer_cles(dernier, tetes[plusPetit],
+                                  disque->tailleCle) != 0)) {
+      ecrire_disque(tetes[plusPetit], t, fusion);
+      memcpy(dernier, tetes[plusPetit], t * sizeof(short));
+      premier = FAUX;
+    }
+    actif[plusPetit] = (fread(tetes[plusPetit], sizeof(short), t,
+                              sequences[plusPetit]) == (size_t)t);
+  }
+  fermer_disque(fusion);
+  for (int s = 0; s < nb; s++) {
+    fclose(sequences[s]);
+    nom_disque(disque, "sequence", s, nom);
+    remove(nom);
+  }
+  nom_disque(disque, "sequence", 0, nom);
+  rename(nomFusion, nom);
+  disque->nbSequences = 1;
+}
+
+/**
+ * @brief Fonction qui retire de la séquence fusionnée les positions déjà
+ * vues : les deux fichiers sont triés, un seul passage suffit. Les positions
+ * restantes forment la nouvelle couche et sont ajoutées aux positions vues.
+ * @param disque t_disque, une seule séquence
+ * @param profondeur int, numéro de la nouvelle couche
+ * @return le nombre de positions de la nouvelle couche
+ */
+long retirer_vues(t_disque *disque, int profondeur) {
+  char nom[TAILLE_NOM_DISQUE], nomVues[TAILLE_NOM_DISQUE];
+  char nomFusion[TAILLE_NOM_DISQUE];
+  short nouveau[MAX_CAISSES + 3], vu[MAX_CAISSES + 3];
+  FILE *sequence = NULL, *vues, *couche, *fusion;
+  int t = disque->taille, ordre;
+  bool resteNouveau = FAUX, resteVu;
+  long nb = 0;
+
+  nom_disque(disque, "vues", 0, nomVues);
+  nom_disque(disque, "fusion", 0, nomFusion);
+  vues = ouvrir_disque(nomVues, "rb");
+  fusion = ouvrir_disque(nomFusion, "wb");
+  nom_disque(disque, "couche", profondeur, nom);
+  couche = ouvrir_disque(nom, "wb");
+  if (disque->nbSequences == 1) {
+    nom_disque(disque, "sequence", 0, nom);
+    sequence = ouvrir_disque(nom, "rb");
+    resteNouveau = (fread(nouveau, sizeof(short), t, sequence) == (size_t)t);
+  }
+  resteVu = (fread(vu, sizeof(short), t, vues) == (size_t)t);
+  while (resteNouveau || resteVu) {
+    ordre = !resteNouveau ? 1
+            : !resteVu    ? -1
+                          : comparer_cles(nouveau, vu, disque->tailleCle);
+    if (ordre < 0) {
+      ecrire_disque(nouveau, t, couche);
+      ecrire_disque(nouveau, t, fusion);
+      nb++;
+    } else {
+      ecrire_disque(vu, t, fusion);
+    }
+    if (ordre <= 0) {
+      resteNouveau = (fread(nouveau, sizeof(short), t, sequence) == (size_t)t);
+    }
+    if (ordre >= 0) {
+      resteVu = (fread(vu, sizeof(short), t, vues) == (size_t)t);
+    }
+  }
+  fclose(vues);
+  fermer_disque(fusion);
+  fermer_disque(couche);
+  if (sequence != NULL) {
+    fclose(sequence);
+    nom_disque(disque, "sequence", 0, nom);
+    remove(nom);
+  }
+  rename(nomFusion, nomVues);
+  disque->nbSequences = 0;
+  return nb;
+}
+
+/**
+ * @brief Fonction qui reconstruit les poussées de la solution en remontant
+ * les couches : le parent d'un enregistrement a la caisse poussée remise à sa
+ * case de départ et le joueur derrière elle, on le cherche par dichotomie
+ * dans le fichier trié de la couche précédente.
+ * @param disque t_disque
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, position de travail
+ * @param but tableau, enregistrement de la position gagnante
+ * @param profondeur int, couche de la position gagnante
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @return le nombre de poussées
+ */
+int remonter_disque(const t_disque *disque, const t_niveau *niveau,
+    t_position *position, short but[], int profondeur, short depart[],
+    short arrivee[]) {
+  char nom[TAILLE_NOM_DISQUE];
+  t_masque atteint;
+  short cle[MAX_CAISSES + 3];
+  int k = disque->nbCaisses, t = disque->taille;
+  FILE *couche;
+  for (int p = profondeur - 1; p >= 0; p--) {
+    depart[p] = but[k + 1];
+    arrivee[p] = but[k + 2];
+    placer_etat(position, niveau, but, but[k]);
+    pousser_caisse(position, niveau, arrivee[p], depart[p]);
+    position->joueur = 2 * depart[p] - arrivee[p];
+    memcpy(cle, position->caisses, k * sizeof(short));
+    cle[k] = acces_joueur(position, niveau, atteint);
+    nom_disque(disque, "couche", p, nom);
+    couche = ouvrir_disque(nom, "rb");
+    if (!chercher_disque(couche, t, disque->tailleCle, cle, but)) {
+      fprintf(stderr, "ERREUR SUR FICHIER %s\n", nom);
+      exit(EXIT_FAILURE);
+    }
+    fclose(couche);
+  }
+  return profondeur;
+}
+
+/**
+ * @brief Fonction qui cherche une clé par dichotomie dans un fichier
+ * d'enregistrements triés.
+ * @param f fichier ouvert en lecture
+ * @param taille int, nombre de valeurs d'un enregistrement
+ * @param tailleCle int, nombre de valeurs de la clé
+ * @param cle tableau, la clé cherchée
+ * @param enregistrement tableau, l'enregistrement trouvé, en sortie
+ * @return VRAI si la clé a été trouvée
+ */
+bool chercher_disque(FILE *f, int taille, int tailleCle, const short cle[],
+    short enregistrement[]) {
+  long debut = 0, fin, milieu;
+  int ordre;
+  fseek(f, 0, SEEK_END);
+  fin = ftell(f) / (long)(taille * sizeof(short));
+  while (debut < fin) {
+    milieu = (debut + fin) / 2;
+    fseek(f, milieu * taille * (long)sizeof(short), SEEK_SET);
+    if (fread(enregistrement, sizeof(short), taille, f) != (size_t)taille) {
+      return FAUX;
+    }
+    ordre = comparer_cles(enregistrement, cle, tailleCle);
+    if (ordre == 0) {
+      return VRAI;
+    } else if (ordre < 0) {
+      debut = milieu + 1;
+    } else {
+      fin = milieu;
+    }
+  }
+  return FAUX;
+}
+
+/**
+ * @brief Fonction qui fait une recherche A* en profondeur itérative (IDA*) :
+ * parcours en profondeur limité par un seuil sur poussées + heuristique, le
+ * seuil est relevé au plus petit dépassement tant que rien n'est trouvé. Les
+ * poussées sont jouées et annulées sur une seule position, comme deplacer()
+ * et annuler_deplacement() sur le plateau, l'affectation est mise à jour de
+ * la même façon : la mémoire ne dépend que de la longueur de la solution, plus
+ * le cache de transposition s'il est demandé.
+ * @param niveau t_niveau, description fixe du niveau
+ * @param position t_position, position de départ (modifiée)
+ * @param cacheMo long, taille du cache en Mo, 0 pour ne pas en avoir
+ * @param macros bool, VRAI pour jouer les macro-coups des tunnels et salles
+ * @param echeance long, heure limite en ms (maintenant_ms()), 0 sans limite
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @param noeudsDeveloppes long, nombre de positions développées, en sortie
+ * @param horsDelai bool, VRAI si l'échéance a arrêté la recherche, en sortie
+ * @return le nombre de coups, AUCUNE_CASE si pas de solution
+ */
+int recherche_ida(const t_niveau *niveau, t_position *position, long cacheMo,
+    bool macros, long echeance, short depart[], short arrivee[],
+    long *noeudsDeveloppes, bool *horsDelai) {
+  t_ida ida;
+  int resultat = AUCUNE_CASE;
+  ida.niveau = niveau;
+  ida.position = position;
+  ida.depart = depart;
+  ida.arrivee = arrivee;
+  ida.noeudsDeveloppes = 0;
+  ida.iteration = 0;
+  ida.macros = macros;
+  ida.nbCoups = 0;
+  ida.echeance = echeance;
+  ida.horsDelai = FAUX;
+  init_cache(&ida.cache, cacheMo);
+  calculer_appariement(niveau, position, &ida.appariement);
+  ida.seuil = valeur_appariement(niveau, &ida.appariement);
+  while ((resultat == AUCUNE_CASE) && (ida.seuil < INFINI_DISTANCE) &&
+         !ida.horsDelai) {
+    ida.prochainSeuil = INFINI_DISTANCE;
+    ida.iteration += 1;
+    if (explorer_ida(&ida, 0, 0)) {
+      resultat = ida.nbCoups;
+    } else {
+      ida.seuil = ida.prochainSeuil;
+    }
+  }
+  free(ida.cache.alveoles);
+  *noeudsDeveloppes = ida.noeudsDeveloppes;
+  *horsDelai = ida.horsDelai;
+  return resultat;
+}
+
+/**
+ * @brief Fonction récursive de recherche_ida() : développe la position
+ * courante si poussées + heuristique ne dépasse pas le seuil. Comme
+ * hors_delai(), l'horloge n'est lue que tous les 1024 noeuds développés.
+ * @param ida t_ida, état de la recherche
+ * @param poussees int, nombre de poussées déjà jouées
+ * @param coups int, nombre de coups déjà joués (un macro-coup compte pour un)
+ * @return VRAI si une solution a été trouvée (elle est dans depart/arrivee)
+ */
+bool explorer_ida(t_ida *ida, int poussees, int coups) {
+  const t_niveau *niveau = ida->niveau;
+  t_position *position = ida->position;
+  t_poussee liste[NB_DIRECTIONS * MAX_CAISSES];
+  t_masque atteint;
+  int f = poussees + valeur_appariement(niveau, &ida->appariement);
+  int nbPoussees, joueur;
+
+  if (ida->horsDelai) {
+    return FAUX; // échéance passée : on remonte sans rien développer
+  }
+  if (f > ida->seuil) {
+    if (f < ida->prochainSeuil) {
+      ida->prochainSeuil = f;
+    }
+    return FAUX;
+  }
+  if (position_gagnante(position, niveau)) {
+    ida->nbCoups = coups;
+    return VRAI;
+  }
+  joueur = acces_joueur(position, niveau, atteint);
+  position->joueur = joueur;
+  if (!noter_cache(&ida->cache, cle_position(position, niveau), poussees,
+                   ida->iteration)) {
+    return FAUX; // déjà développée avec moins de poussées à ce seuil
+  }
+  ida->noeudsDeveloppes += 1;
+  if ((ida->echeance > 0) && ((ida->noeudsDeveloppes & 1023) == 0) &&
+      (maintenant_ms() > ida->echeance)) {
+    ida->horsDelai = VRAI;
+    return FAUX;
+  }
+  nbPoussees = lister_poussees(position, niveau, atteint, liste);
+  if (ida->macros) {
+    etendre_macros(position, niveau, liste, nbPoussees);
+  }
+  for (int p = 0; p < nbPoussees; p++) {
+    if (!jouer_poussee(position, niveau, liste[p])) {
+      continue;
+    }
+    deplacer_appariement(niveau, &ida->appariement, liste[p].depart,
+                         liste[p].arrivee);
+    ida->depart[coups] = liste[p].depart;
+    ida->arrivee[coups] = liste[p].arrivee;
+    if ((coups + 1 < TAILLE_DEPLACEMENT) &&
+        explorer_ida(ida, poussees + liste[p].cout, coups + 1)) {
+      return VRAI;
+    }
+    deplacer_appariement(niveau, &ida->appariement, liste[p].arrivee,
+                         liste[p].depart);
+    annuler_poussee(position, niveau, liste[p]);
+    position->joueur = joueur;
+  }
+  return FAUX;
+}
+
+/**
+ * @brief Procédure qui alloue le cache de transposition de IDA*.
+ * @param cache t_cache, en sortie
+ * @param cacheMo long, taille en Mo, 0 pour un cache vide
+ */
+void init_cache(t_cache *cache, long cacheMo) {
+  size_t memoire = (size_t)cacheMo * 1024 * 1024;
+  cache->taille = 0;
+  cache->alveoles = NULL;
+  if (memoire >= sizeof(t_alveole)) {
+    cache->taille = 1;
+    while (cache->taille * 2 * sizeof(t_alveole) <= memoire) {
+      cache->taille *= 2;
+    }
+    cache->alveoles = calloc(cache->taille, sizeof(t_alveole));
+    if (cache->alveoles == NULL) {
+      cache->taille = 0;
+    }
+  }
+}
+
+/**
+ * @brief Fonction qui consulte et met à jour le cache de transposition : une
+ * alvéole par clé (la plus récente remplace l'ancienne). Une position déjà
+ * développée pendant la même itération avec au plus autant de poussées n'a
+ * pas à l'être de nouveau.
+ * @param cache t_cache
+ * @param cle uint64_t, clé de la position
+ * @param poussees int, nombre de poussées jouées
+ * @param iteration int, numéro de l'itération de IDA*
+ * @return FAUX si la position peut être coupée
+ */
+bool noter_cache(t_cache *cache, uint64_t cle, int poussees, int iteration) {
+  t_alveole *alveole;
+  if (cache->taille == 0) {
+    return VRAI;
+  }
+  alveole = &cache->alveoles[cle & (cache->taille - 1)];
+  if ((alveole->cle == cle) && (alveole->iteration == iteration) &&
+      (alveole->poussees <= poussees)) {
+    return FAUX;
+  }
+  alveole->cle = cle;
+  alveole->iteration = iteration;
+  alveole->poussees = poussees;
+  return VRAI;
+}
+
+/**
+ * @brief Fonction qui remonte les parents depuis le noeud gagnant pour obtenir
+ * la liste des poussées dans l'ordre.
+ * @param solveur t_solveur
+ * @param noeud int, indice du noeud gagnant
+ * @param depart tableau des cases de départ des caisses, en sortie
+ * @param arrivee tableau des cases d'arrivée des caisses, en sortie
+ * @return le nombre de poussées
+ */
+int extraire_poussees(const t_solveur *solveur, int noeud, short depart[],
+    short arrivee[]) {
+  int nb = 0, i;
+  for (i = noeud; solveur->noeuds[i].parent != AUCUNE_CASE;
+       i = solveur->noeuds[i].parent) {
+    nb++;
+  }
+  i = noeud;
+  for (int p = nb - 1; p >= 0; p--) {
+    depart[p] = solveur->noeuds[i].depart;
+    arrivee[p] = solveur->noeuds[i].arrivee;
+    i = solveur->noeuds[i].parent;
+  }
+  return nb;
+}
+
+/**
+ * @brief Fonction qui rejoue les poussées avec deplacer() : le joueur marche
+ * par le plus court chemin jusqu'à la caisse puis la pousse. Les déplacements
+ * sont donc mémorisés exactement comme pendant une partie.
+ * @param plateau t_plateau, plateau de départ (modifié)
+ * @param plateauBase t_plateau, plateau de base du niveau
+ * @param niveau t_niveau, description fixe du niveau
+ * @param depart tableau des cases de départ des caisses
+ * @param arrivee tableau des cases d'arrivée des caisses
+ * @param nbPoussees int, nombre de poussées
+ * @param historique t_historique, déplacements en sortie
+ * @param nbDeplacement int, nombre de déplacements en sortie
+ * @return VRAI si la partie est gagnée à la fin des poussées
+ */
+bool construire_deplacements(t_plateau *plateau, t_plateau *plateauBase,
+    const t_niveau *niveau, short depart[], short arrivee[], int nbPoussees,
+    t_historique *historique, int *nbDeplacement) {
+  char touches[MAX_CASES];
+  int nbTouches, posJoX = 0, posJoY = 0, d, caisse;
+  recherche_pos_jo(plateau, &posJoX, &posJoY);
+  *nbDeplacement = 0;
+  for (int p = 0; p < nbPoussees; p++) {
+    d = 0;
+    while ((d < NB_DIRECTIONS - 1) &&
+           ((arrivee[p] - depart[p]) % niveau->decalage[d] != 0 ||
+            (arrivee[p] - depart[p]) / niveau->decalage[d] <= 0)) {
+      d++;
+    }
+    caisse = depart[p] - niveau->decalage[d];
+    if (!chemin_joueur(plateau, plateauBase, posJoX, posJoY,
+                       caisse / niveau->largeur, caisse % niveau->largeur,
+                       touches, &nbTouches)) {
+      return FAUX;
+    }
+    for (caisse = depart[p]; caisse != arrivee[p];
+         caisse += niveau->decalage[d]) {
+      touches[nbTouches++] = touche_direction(d);
+    }
+    for (int t = 0; t < nbTouches; t++) {
+      deplacer(plateau, plateauBase, historique, touches[t], &posJoX,
+               &posJoY, nbDeplacement);
+    }
+  }
+  return gagne(plateau);
+}
+
+/**
+ * @brief Fonction qui cherche le plus court chemin du joueur sans pousser de
+ * caisse (parcours en largeur sur le plateau de jeu).
+ * @param plateau t_plateau, caisses et joueur
+ * @param plateauBase t_plateau, murs et cibles
+ * @param depX int, ligne de départ
+ * @param depY int, colonne de départ
+ * @param arrX int, ligne d'arrivée
+ * @param arrY int, colonne d'arrivée
+ * @param touches tableau des touches du chemin, en sortie
+ * @param nbTouches int, nombre de touches, en sortie
+ * @return VRAI si un chemin existe
+ */
+bool chemin_joueur(t_plateau *plateau, t_plateau *plateauBase, int depX,
+    int depY, int arrX, int arrY, char touches[], int *nbTouches) {
+  int precedent[MAX_CASES], file[MAX_CASES];
+  int largeur = plateau->largeur, debut = 0, fin = 0, laCase, voisine;
+  int decalage[NB_DIRECTIONS] = {-largeur, largeur, -1, 1};
+  int depart = depX * largeur + depY, arrivee = arrX * largeur + arrY;
+  char c;
+  for (int i = 0; i < plateau->hauteur * largeur; i++) {
+    precedent[i] = AUCUNE_CASE;
+  }
+  file[fin++] = depart;
+  precedent[depart] = depart;
+  // le bord de murs arrête le parcours, pas de test de sortie du plateau
+  while ((debut < fin) && (precedent[arrivee] == AUCUNE_CASE)) {
+    laCase = file[debut++];
+    for (int d = 0; d < NB_DIRECTIONS; d++) {
+      voisine = laCase + decalage[d];
+      if ((precedent[voisine] == AUCUNE_CASE) &&
+          (plateauBase->cases[voisine] != BORD) &&
+          est_libre(plateau->cases[voisine])) {
+        precedent[voisine] = laCase;
+        file[fin++] = voisine;
+      }
+    }
+  }
+  if (precedent[arrivee] == AUCUNE_CASE) {
+    return FAUX;
+  }
+  // remontée du chemin depuis l'arrivée puis inversion
+  *nbTouches = 0;
+  for (laCase = arrivee; laCase != depart; laCase = precedent[laCase]) {
+    int ecart = laCase - precedent[laCase];
+    if (ecart == -largeur) {
+      touches[(*nbTouches)++] = HAUT;
+    } else if (ecart == largeur) {
+      touches[(*nbTouches)++] = BAS;
+    } else if (ecart == -1) {
+      touches[(*nbTouches)++] = GAUCHE;
+    } else {
+      touches[(*nbTouches)++] = DROITE;
+    }
+  }
+  for (int i = 0; i < *nbTouches / 2; i++) {
+    c = touches[i];
+    touches[i] = touches[*nbTouches - 1 - i];
+    touches[*nbTouches - 1 - i] = c;
+  }
+  return VRAI;
+}
+
+/**
+ * @brief Fonction qui donne la touche de jeu d'une direction du solveur.
+ * @param direction int, 0 haut, 1 bas, 2 gauche, 3 droite
+ */
+char touche_direction(int direction) {
+  char touche = DROITE;
+  if (direction == 0) {
+    touche = HAUT;
+  } else if (direction == 1) {
+    touche = BAS;
+  } else if (direction == 2) {
+    touche = GAUCHE;
+  }
+  return touche;
 }
 
 // Copyright (c) 2025 Titouan Moquet